@@ -41,7 +41,21 @@ module core_wrapper import muntjac_pkg::*; #(
     output csr_num_e        dbg_csr_o,
     output logic [63:0]     dbg_csr_data_o,
 `endif
-    output logic [63:0]     dbg_pc_o
+    output logic [63:0]     dbg_pc_o,
+    output logic [HPM_EVENT_NUM-1:0] dbg_hpm_event_o,
+
+    // Branch predictor accuracy
+    output logic            dbg_branch_resolved_o,
+    output branch_type_e    dbg_branch_type_o,
+    output logic [63:0]     dbg_branch_pc_o,
+    output logic [63:0]     dbg_branch_target_o,
+    output logic            dbg_branch_mispredict_o,
+    output logic            dbg_branch_predicted_o,
+
+    // Interrupt latency
+    output logic            dbg_trap_valid_o,
+    output exc_cause_e      dbg_trap_cause_o,
+    output logic [63:0]     dbg_trap_tvec_o
 
 );
 
@@ -198,15 +212,17 @@ module core_wrapper import muntjac_pkg::*; #(
     `TL_CONNECT_HOST_PORT(device, io)
   );
 
+  // Uncached I/O regions: the CLINT at 0x02000000, the PLIC at 0x0c000000,
+  // other memory-mapped devices at 0x10000000-0x1fffffff, and tohost/fromhost.
   `TL_DECLARE(64, 56, 4, SinkWidth, ch_aggregate);
   tl_socket_1n #(
     .SourceWidth (4),
     .SinkWidth   (SinkWidth),
     .NumLinks    (2),
-    .NumAddressRange (1),
-    .AddressBase ({56'h80010000}),
-    .AddressMask ({56'h      3f}),
-    .AddressLink ({1'd        1}),
+    .NumAddressRange (4),
+    .AddressBase ({56'h02000000, 56'h0c000000, 56'h10000000, 56'h80010000}),
+    .AddressMask ({56'h    ffff, 56'h 3ffffff, 56'h0fffffff, 56'h      3f}),
+    .AddressLink ({1'd        1, 1'd        1, 1'd        1, 1'd        1}),
     .NumSinkRange (1),
     .SinkBase ({IoSinkBase}),
     .SinkMask ({IoSinkMask}),
@@ -219,11 +235,15 @@ module core_wrapper import muntjac_pkg::*; #(
   );
 
   instr_trace_t dbg_o;
+  branch_trace_t dbg_branch_o;
+  trap_trace_t dbg_trap_o;
 
   muntjac_core #(
     .SourceWidth (4),
     .SinkWidth (SinkWidth),
-    .RV64F (muntjac_pkg::RV64FFull)
+    .RV64F (muntjac_pkg::RV64FFull),
+    .MHPMICacheEnable (1'b1),
+    .MHPMDCacheEnable (1'b1)
   ) core (
     .clk_i (clk_i),
     .rst_ni (rst_ni),
@@ -233,12 +253,24 @@ module core_wrapper import muntjac_pkg::*; #(
     .irq_external_m_i,
     .irq_external_s_i,
     .hart_id_i,
-    .hpm_event_i ({hpm_miss, hpm_rel_count, hpm_acq_count, 3'b0, 3'b0, 1'b0}),
-    .dbg_o
+    .hpm_event_i ({6'b0, hpm_miss, hpm_rel_count, hpm_acq_count, 3'b0, 3'b0, 1'b0}),
+    .hpm_event_o (dbg_hpm_event_o),
+    .dbg_o,
+    .dbg_branch_o,
+    .dbg_trap_o
   );
 
   // Debug connections
   assign dbg_pc_o = dbg_o.pc;
+  assign dbg_branch_resolved_o = dbg_branch_o.resolved;
+  assign dbg_branch_type_o = dbg_branch_o.branch_type;
+  assign dbg_branch_pc_o = dbg_branch_o.pc;
+  assign dbg_branch_target_o = dbg_branch_o.target;
+  assign dbg_branch_mispredict_o = dbg_branch_o.mispredict;
+  assign dbg_branch_predicted_o = dbg_branch_o.predicted;
+  assign dbg_trap_valid_o = dbg_trap_o.valid;
+  assign dbg_trap_cause_o = dbg_trap_o.cause;
+  assign dbg_trap_tvec_o = dbg_trap_o.tvec;
 `ifdef TRACE_ENABLE
   assign dbg_instr_word_o = dbg_o.instr_word;
   assign dbg_mode_o = dbg_o.mode;
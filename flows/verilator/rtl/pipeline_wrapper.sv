@@ -64,7 +64,21 @@ module pipeline_wrapper import muntjac_pkg::*; #(
     output csr_num_e        dbg_csr_o,
     output logic [63:0]     dbg_csr_data_o,
 `endif
-    output logic [63:0]     dbg_pc_o
+    output logic [63:0]     dbg_pc_o,
+    output logic [HPM_EVENT_NUM-1:0] dbg_hpm_event_o,
+
+    // Branch predictor accuracy
+    output logic            dbg_branch_resolved_o,
+    output branch_type_e    dbg_branch_type_o,
+    output logic [63:0]     dbg_branch_pc_o,
+    output logic [63:0]     dbg_branch_target_o,
+    output logic            dbg_branch_mispredict_o,
+    output logic            dbg_branch_predicted_o,
+
+    // Interrupt latency
+    output logic            dbg_trap_valid_o,
+    output exc_cause_e      dbg_trap_cause_o,
+    output logic [63:0]     dbg_trap_tvec_o
 
 );
 
@@ -74,6 +88,8 @@ module pipeline_wrapper import muntjac_pkg::*; #(
   dcache_d2h_t dcache_d2h;
 
   instr_trace_t dbg_o;
+  branch_trace_t dbg_branch_o;
+  trap_trace_t dbg_trap_o;
 
   muntjac_pipeline #(
     .RV64F (muntjac_pkg::RV64FFull)
@@ -89,7 +105,11 @@ module pipeline_wrapper import muntjac_pkg::*; #(
       .irq_external_m_i,
       .irq_external_s_i,
       .hart_id_i,
-      .dbg_o
+      .hpm_event_i ('0),
+      .hpm_event_o (dbg_hpm_event_o),
+      .dbg_o,
+      .dbg_branch_o,
+      .dbg_trap_o
   );
 
   // Instruction cache interface
@@ -127,6 +147,15 @@ module pipeline_wrapper import muntjac_pkg::*; #(
 
   // Debug connections
   assign dbg_pc_o = dbg_o.pc;
+  assign dbg_branch_resolved_o = dbg_branch_o.resolved;
+  assign dbg_branch_type_o = dbg_branch_o.branch_type;
+  assign dbg_branch_pc_o = dbg_branch_o.pc;
+  assign dbg_branch_target_o = dbg_branch_o.target;
+  assign dbg_branch_mispredict_o = dbg_branch_o.mispredict;
+  assign dbg_branch_predicted_o = dbg_branch_o.predicted;
+  assign dbg_trap_valid_o = dbg_trap_o.valid;
+  assign dbg_trap_cause_o = dbg_trap_o.cause;
+  assign dbg_trap_tvec_o = dbg_trap_o.tvec;
 `ifdef TRACE_ENABLE
   assign dbg_instr_word_o = dbg_o.instr_word;
   assign dbg_mode_o = dbg_o.mode;
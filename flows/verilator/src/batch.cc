@@ -0,0 +1,164 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#include "batch.h"
+#include "logs.h"
+
+using std::ifstream;
+using std::ofstream;
+using std::stringstream;
+
+// Escape characters which are not allowed to appear in XML attributes.
+static string xml_escape(const string& str) {
+  string result;
+
+  for (char c : str) {
+    switch (c) {
+      case '&':  result += "&amp;";  break;
+      case '<':  result += "&lt;";   break;
+      case '>':  result += "&gt;";   break;
+      case '"':  result += "&quot;"; break;
+      case '\'': result += "&apos;"; break;
+      default:   result += c;        break;
+    }
+  }
+
+  return result;
+}
+
+vector<batch_entry_t> read_batch_list(string filename) {
+  vector<batch_entry_t> entries;
+
+  ifstream file(filename);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to read batch list from " << filename << endl;
+    exit(1);
+  }
+
+  string line;
+  while (std::getline(file, line)) {
+    stringstream ss(line);
+    batch_entry_t entry;
+    string token;
+
+    while (ss >> token)
+      entry.push_back(token);
+
+    if (entry.empty() || entry[0][0] == '#')
+      continue;
+
+    entries.push_back(entry);
+  }
+
+  file.close();
+
+  return entries;
+}
+
+string batch_entry_name(const batch_entry_t& entry) {
+  string name;
+
+  for (size_t i=0; i<entry.size(); i++) {
+    if (i > 0)
+      name += " ";
+    name += entry[i];
+  }
+
+  return name;
+}
+
+// Fixed-size subset of `batch_result_t` which can be copied through a pipe.
+typedef struct {
+  int      exit_code;
+  bool     timed_out;
+  bool     passed;
+  uint64_t cycles;
+  uint64_t instructions;
+  double   seconds;
+} batch_message_t;
+
+void send_batch_result(int fd, const batch_result_t& result) {
+  batch_message_t message;
+  message.exit_code = result.exit_code;
+  message.timed_out = result.timed_out;
+  message.passed = result.passed;
+  message.cycles = result.cycles;
+  message.instructions = result.instructions;
+  message.seconds = result.seconds;
+
+  // The message is smaller than PIPE_BUF, so the write is atomic.
+  if (write(fd, &message, sizeof(message)) != sizeof(message))
+    MUNTJAC_ERROR << "Unable to send batch result to parent process" << endl;
+}
+
+bool receive_batch_result(int fd, batch_result_t& result) {
+  batch_message_t message;
+
+  if (read(fd, &message, sizeof(message)) != sizeof(message))
+    return false;
+
+  result.exit_code = message.exit_code;
+  result.timed_out = message.timed_out;
+  result.passed = message.passed;
+  result.cycles = message.cycles;
+  result.instructions = message.instructions;
+  result.seconds = message.seconds;
+
+  return true;
+}
+
+void write_junit_xml(string filename, string suite_name,
+                     const vector<batch_result_t>& results) {
+  ofstream file(filename);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to write batch report to " << filename << endl;
+    return;
+  }
+
+  int failures = 0;
+  double total_time = 0;
+  for (auto& result : results) {
+    if (!result.passed)
+      failures++;
+    total_time += result.seconds;
+  }
+
+  file << std::fixed << std::setprecision(3);
+  file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+  file << "<testsuite name=\"" << xml_escape(suite_name) << "\""
+       << " tests=\"" << results.size() << "\""
+       << " failures=\"" << failures << "\""
+       << " time=\"" << total_time << "\">\n";
+
+  for (auto& result : results) {
+    file << "  <testcase classname=\"Test\" name=\"" << xml_escape(result.name)
+         << "\" time=\"" << result.seconds << "\">\n";
+
+    file << "    <properties>\n";
+    file << "      <property name=\"exit_code\" value=\"" << result.exit_code << "\"/>\n";
+    file << "      <property name=\"timed_out\" value=\"" << (result.timed_out ? "true" : "false") << "\"/>\n";
+    file << "      <property name=\"cycles\" value=\"" << result.cycles << "\"/>\n";
+    file << "      <property name=\"instructions\" value=\"" << result.instructions << "\"/>\n";
+    file << "    </properties>\n";
+
+    if (result.timed_out)
+      file << "    <failure type=\"timeout\">Timed out after "
+           << result.cycles << " cycles</failure>\n";
+    else if (!result.passed)
+      file << "    <failure type=\"failure\">Exited with argument "
+           << result.exit_code << "</failure>\n";
+
+    file << "  </testcase>\n";
+  }
+
+  file << "</testsuite>\n";
+  file.close();
+}
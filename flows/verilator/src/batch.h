@@ -0,0 +1,55 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Support for executing many programs in a single simulator process.
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// One program to execute: the executable followed by its arguments.
+typedef vector<string> batch_entry_t;
+
+// Outcome of executing one program.
+typedef struct {
+  // Executable and arguments, separated by spaces.
+  string   name;
+
+  // Value returned by the program (meaningless if timed out).
+  int      exit_code;
+  bool     timed_out;
+  bool     passed;
+
+  uint64_t cycles;
+  uint64_t instructions;
+
+  // Host time taken.
+  double   seconds;
+} batch_result_t;
+
+// Read a list of programs to execute. Each non-empty line holds an executable
+// followed by any arguments, separated by whitespace. Lines starting with '#'
+// are ignored.
+vector<batch_entry_t> read_batch_list(string filename);
+
+// Join an entry back into a single string, for reporting.
+string batch_entry_name(const batch_entry_t& entry);
+
+// Transfer a result between processes through a pipe. The name is not sent:
+// the receiver is expected to know which entry the result belongs to.
+// `receive_batch_result` returns false if the sender exited without sending.
+void send_batch_result(int fd, const batch_result_t& result);
+bool receive_batch_result(int fd, batch_result_t& result);
+
+// Write a JUnit-style XML report describing all results.
+void write_junit_xml(string filename, string suite_name,
+                     const vector<batch_result_t>& results);
+
+#endif  // BATCH_H
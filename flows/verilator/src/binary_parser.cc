@@ -6,22 +6,21 @@
 //   http://wiki.osdev.org/ELF_Tutorial
 //   https://code.google.com/p/elfinfo/source/browse/trunk/elfinfo.c
 
-// TODO
-//  * Check that arguments should be stored the same way as Loki.
-
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 #include <elf.h>
-#include <fstream>
-#include <iostream>
-#include <stdio.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 #include "binary_parser.h"
 #include "logs.h"
 #include "main_memory.h"
 
-using std::ifstream;
 using std::vector;
 
 // Older versions of elf.h do not contain this value.
@@ -29,180 +28,232 @@ using std::vector;
   #define EM_RISCV 0xf3
 #endif
 
-DataBlock arguments(int argc, char** argv) {
-  // Target memory looks like this:
-  // 0x00000000 zero word
-  // 0x00000004 argc word
-  // 0x00000008 start of argv
-  // ...
-  // 0x0000???? end of argv
-  // 0x0000???? zero word
-  // 0x0000???? start of data pointed to by argv
-
-  // Start of argv storage.
-  size_t argv_ptr = 4 + 4 + argc * 8 + 4;
-
-  // Fixed-size allocation for now.
-  char* data = new char[1024];
-
-  *((uint32_t*)data) = 0;
-  *((uint32_t*)(data + 4)) = argc;
-  *((uint32_t*)(data + 4 + 4 + argc * 8)) = 0;
-
-  for (int i=0; i<argc; i++) {
-    // Muntjac pointers are 64 bits, so cast to a datatype known to be that
-    // length.
-    *((uint64_t*)(data + 4 + 4 + i * 8)) = argv_ptr;
-    strcpy(data + argv_ptr, argv[i]);
-    argv_ptr += strlen(argv[i]);
-    assert(argv_ptr < 1024);
+BinaryParser::BinaryParser(const char* filename) :
+    filename(filename) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Couldn't open " + this->filename + ": " +
+                             strerror(errno));
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0 || file_info.st_size == 0) {
+    close(fd);
+    throw std::runtime_error("Couldn't read " + this->filename);
   }
 
-  // Wrap the array in a shared_ptr so the DataBlock can be copied safely.
-  shared_ptr<char> data_ptr(data, std::default_delete<char[]>());
-  return DataBlock(0, argv_ptr, data_ptr);
-}
+  size = file_info.st_size;
+  void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
 
-Elf64_Ehdr get_elf_header(ifstream& file) {
-  Elf64_Ehdr header;
-  file.seekg(0, file.beg);
-  file.read((char*)&header, sizeof(Elf64_Ehdr));
+  if (mapping == MAP_FAILED)
+    throw std::runtime_error("Couldn't map " + this->filename + ": " +
+                             strerror(errno));
 
-  if (header.e_machine != EM_RISCV)
-    throw std::runtime_error("Received non-RISC-V binary");
+  data = (char*)mapping;
 
-  return header;
-}
+  if (size < sizeof(Elf64_Ehdr) ||
+      memcmp(elf_header().e_ident, ELFMAG, SELFMAG) != 0 ||
+      elf_header().e_ident[EI_CLASS] != ELFCLASS64) {
+    munmap(data, size);
+    throw std::runtime_error(this->filename + " is not a 64-bit ELF file");
+  }
 
-Elf64_Shdr get_section_header(ifstream& file, Elf64_Ehdr& elf_header,
-                              int section) {
-  int num_sections = elf_header.e_shnum;
+  if (elf_header().e_machine != EM_RISCV) {
+    munmap(data, size);
+    throw std::runtime_error("Received non-RISC-V binary");
+  }
+}
 
-  assert(section >= 0);
-  assert(section < num_sections);
+BinaryParser::~BinaryParser() {
+  munmap(data, size);
+}
 
-  Elf64_Shdr section_header;
-  uint offset = elf_header.e_shoff + elf_header.e_shentsize*section;
-  file.seekg(offset, file.beg);
-  file.read((char*)&section_header, sizeof(Elf64_Shdr));
+const char* BinaryParser::contents(uint64_t offset, uint64_t length) const {
+  if (offset > size || length > size - offset)
+    throw std::runtime_error("Truncated ELF file: " + filename);
 
-  return section_header;
+  return data + offset;
 }
 
-Elf64_Sym get_symbol(ifstream& file, Elf64_Shdr& section_header, int symbol) {
-  int num_symbols = section_header.sh_size / section_header.sh_entsize;
-
-  assert(symbol >= 0);
-  assert(symbol < num_symbols);
+const Elf64_Ehdr& BinaryParser::elf_header() const {
+  return *(const Elf64_Ehdr*)data;
+}
 
-  Elf64_Sym sym;
-  uint offset = section_header.sh_offset + section_header.sh_entsize*symbol;
-  file.seekg(offset, file.beg);
-  file.read((char*)&sym, sizeof(Elf64_Sym));
+const Elf64_Shdr& BinaryParser::section_header(int section) const {
+  assert(section >= 0);
+  assert(section < elf_header().e_shnum);
 
-  return sym;
+  uint64_t offset = elf_header().e_shoff +
+                    (uint64_t)elf_header().e_shentsize * section;
+  return *(const Elf64_Shdr*)contents(offset, sizeof(Elf64_Shdr));
 }
 
-DataBlock get_section(ifstream& file, Elf64_Shdr& header) {
-  uint64_t size = header.sh_size;
-  uint64_t position = header.sh_addr;
-  uint64_t offset = header.sh_offset;
+void BinaryParser::load(MainMemory& memory) const {
+  for (int i=0; i<elf_header().e_shnum; i++) {
+    const Elf64_Shdr& header = section_header(i);
 
-  char* data = new char[size];
-  file.seekg(offset, file.beg);
-  file.read(data, size);
-
-  // TODO: use this field?
-  bool read_only = !(header.sh_flags & SHF_WRITE);
+    // We are only interested in sections to be loaded into memory.
+    if (!(header.sh_flags & SHF_ALLOC) ||  // Alloc = put in memory
+        (header.sh_type == SHT_NOBITS))    // No bits = data not in ELF
+      continue;
 
-  // Wrap the array in a shared_ptr so the DataBlock can be copied safely.
-  shared_ptr<char> data_ptr(data, std::default_delete<char[]>());
-  return DataBlock(position, size, data_ptr);
+    // Memory copies the data, so point straight into the mapping rather than
+    // taking ownership.
+    char* section = const_cast<char*>(contents(header.sh_offset,
+                                               header.sh_size));
+    shared_ptr<char> data_ptr(section, [](char*) {});
+    memory.write(DataBlock(header.sh_addr, header.sh_size, data_ptr));
+  }
 }
 
-vector<DataBlock> elf(char* filename) {
-  ifstream file(filename);
+MemoryAddress BinaryParser::program_headers_address() const {
+  const Elf64_Ehdr& header = elf_header();
 
-  Elf64_Ehdr elf_header = get_elf_header(file);
+  for (int i=0; i<header.e_phnum; i++) {
+    uint64_t offset = header.e_phoff + (uint64_t)header.e_phentsize * i;
+    const Elf64_Phdr& segment =
+        *(const Elf64_Phdr*)contents(offset, sizeof(Elf64_Phdr));
 
-  int num_sections = elf_header.e_shnum;
-  vector<DataBlock> blocks;
-  for (int i=0; i<num_sections; i++) {
-    Elf64_Shdr section_header = get_section_header(file, elf_header, i);
+    if (segment.p_type == PT_LOAD && segment.p_offset <= header.e_phoff &&
+        header.e_phoff < segment.p_offset + segment.p_filesz)
+      return segment.p_vaddr + (header.e_phoff - segment.p_offset);
+  }
 
-    // We are only interested in sections to be loaded into memory.
-    if ((section_header.sh_flags & SHF_ALLOC) &&   // Alloc = put in memory
-        (section_header.sh_type != SHT_NOBITS)) {  // No bits = data not in ELF
-      DataBlock data = get_section(file, section_header);
-      blocks.push_back(data);
-    }
+  return 0;
+}
+
+MemoryAddress BinaryParser::write_stack(int argc, char** argv,
+                                        const vector<string>& envp,
+                                        MemoryAddress stack_top,
+                                        MainMemory& memory) const {
+  // Stack layout, as set up by Linux and the RISC-V proxy kernel:
+  //   stack_top
+  //   strings pointed to by argv and envp
+  //   AT_RANDOM bytes
+  //   (padding to 16 bytes)
+  //   auxv pairs, ending with AT_NULL
+  //   envp pointers, ending with NULL
+  //   argv pointers, ending with NULL
+  //   argc                                   <- returned stack pointer
+
+  MemoryAddress position = stack_top;
+
+  // Copy a string to the top of the stack and return its address.
+  auto push_string = [&](const char* str, size_t length) {
+    position -= length + 1;
+    memory.write(position, str, length + 1);
+    return position;
+  };
+
+  vector<uint64_t> pointers;
+  pointers.push_back(argc);
+
+  for (int i=0; i<argc; i++)
+    pointers.push_back(push_string(argv[i], strlen(argv[i])));
+  pointers.push_back(0);
+
+  for (const string& variable : envp)
+    pointers.push_back(push_string(variable.c_str(), variable.length()));
+  pointers.push_back(0);
+
+  // Bytes for the C library to seed stack protection. Fixed so simulations
+  // are repeatable.
+  const char random[16] = {0x6d, 0x75, 0x6e, 0x74, 0x6a, 0x61, 0x63, 0x00,
+                           0x5f, 0x73, 0x74, 0x61, 0x63, 0x6b, 0x00, 0x00};
+  position -= sizeof(random);
+  memory.write(position, random, sizeof(random));
+  MemoryAddress random_address = position;
+
+  const Elf64_Ehdr& header = elf_header();
+  MemoryAddress phdr = program_headers_address();
+  if (phdr != 0) {
+    pointers.push_back(AT_PHDR);  pointers.push_back(phdr);
+    pointers.push_back(AT_PHENT); pointers.push_back(header.e_phentsize);
+    pointers.push_back(AT_PHNUM); pointers.push_back(header.e_phnum);
+  }
+  pointers.push_back(AT_PAGESZ);  pointers.push_back(4096);
+  pointers.push_back(AT_ENTRY);   pointers.push_back(header.e_entry);
+  pointers.push_back(AT_RANDOM);  pointers.push_back(random_address);
+  if (argc > 0) {
+    pointers.push_back(AT_EXECFN); pointers.push_back(pointers[1]);
   }
+  pointers.push_back(AT_NULL);    pointers.push_back(0);
 
-  file.close();
+  // The stack pointer must be 16-byte aligned.
+  position -= pointers.size() * sizeof(uint64_t);
+  position &= ~(MemoryAddress)0xf;
+  memory.write(position, (const char*)pointers.data(),
+               pointers.size() * sizeof(uint64_t));
 
-  return blocks;
+  return position;
 }
 
-// Load the contents of a RISC-V executable and its arguments into `memory`.
-void BinaryParser::load_elf(int argc, char** argv, MainMemory& memory) {
-  if (argc < 1)
-    throw std::runtime_error("No binary file specified");
+MemoryAddress BinaryParser::entry_point() const {
+  return elf_header().e_entry;
+}
 
-  // Program arguments.
-  memory.write(arguments(argc, argv));
+MemoryAddress BinaryParser::end_address() const {
+  MemoryAddress end = 0;
 
-  // Program.
-  vector<DataBlock> blocks = elf(argv[0]);
-  for (int i=0; i<blocks.size(); i++)
-    memory.write(blocks[i]);
-}
+  for (int i=0; i<elf_header().e_shnum; i++) {
+    const Elf64_Shdr& header = section_header(i);
 
-MemoryAddress BinaryParser::entry_point(char* filename) {
-  // Most of this work already happens in load_elf - optimisation opportunity.
-  ifstream file(filename);
-  Elf64_Ehdr elf_header = get_elf_header(file);
-  file.close();
-  return elf_header.e_entry;
+    if ((header.sh_flags & SHF_ALLOC) && (header.sh_addr + header.sh_size > end))
+      end = header.sh_addr + header.sh_size;
+  }
+
+  return end;
 }
 
-MemoryAddress BinaryParser::symbol_location(char* file_name,
-                                            std::string symbol_name) {
-  ifstream file(file_name);
-  Elf64_Ehdr elf_header = get_elf_header(file);
+void BinaryParser::read_symbols(SymbolTable& table) const {
+  table.clear();
+
+  // Only symbols in executable sections can be functions.
+  int num_sections = elf_header().e_shnum;
+  vector<bool> executable(num_sections);
+  for (int i=0; i<num_sections; i++)
+    executable[i] = section_header(i).sh_flags & SHF_EXECINSTR;
 
-  int num_sections = elf_header.e_shnum;
   for (int i=0; i<num_sections; i++) {
-    Elf64_Shdr section_header = get_section_header(file, elf_header, i);
+    const Elf64_Shdr& header = section_header(i);
 
-    if (section_header.sh_type != SHT_SYMTAB)
+    if (header.sh_type != SHT_SYMTAB || header.sh_entsize < sizeof(Elf64_Sym))
       continue;
 
-    int num_symbols = section_header.sh_size / section_header.sh_entsize;
-    for (int j=0; j<num_symbols; j++) {
-      Elf64_Sym symbol = get_symbol(file, section_header, j);
-
-      // Section where the names are.
-      Elf64_Shdr target = get_section_header(file, elf_header,
-                                             section_header.sh_link);
-      uint64_t name_location = target.sh_offset + symbol.st_name;
-      if (file.fail())
-        break;
-
-      // +1 for null terminator.
-      char name[symbol_name.length()+1];
-      file.seekg(name_location, file.beg);
-      file.read(name, symbol_name.length()+1);
-
-      if (std::string(name) == symbol_name) {
-        file.close();
-        return symbol.st_value;
-      }
-    }
-  }
+    const Elf64_Shdr& names_header = section_header(header.sh_link);
+    const char* names = contents(names_header.sh_offset, names_header.sh_size);
+    const char* symbols = contents(header.sh_offset, header.sh_size);
+
+    uint64_t num_symbols = header.sh_size / header.sh_entsize;
+    table.reserve(num_symbols);
+
+    // Symbol 0 is always undefined.
+    for (uint64_t j=1; j<num_symbols; j++) {
+      const Elf64_Sym& symbol =
+          *(const Elf64_Sym*)(symbols + j * header.sh_entsize);
+
+      if (symbol.st_name == 0 || symbol.st_name >= names_header.sh_size)
+        continue;
 
-  file.close();
+      // String tables should be null-terminated, but don't trust that.
+      const char* name_start = names + symbol.st_name;
+      size_t name_length = strnlen(name_start,
+                                   names_header.sh_size - symbol.st_name);
+      std::string name(name_start, name_length);
 
-  MUNTJAC_WARN << "Couldn't find symbol \"" << symbol_name << "\" in ELF" << endl;
+      // Skip assembler-generated local labels.
+      if (name.compare(0, 2, ".L") == 0)
+        continue;
+
+      // Hand-written assembly often labels functions without a type.
+      int type = ELF64_ST_TYPE(symbol.st_info);
+      bool function = (type == STT_FUNC || type == STT_NOTYPE) &&
+                      symbol.st_shndx < num_sections &&
+                      executable[symbol.st_shndx];
+
+      table.add({name, symbol.st_value, symbol.st_size}, function);
+    }
+  }
 
-  return -1;
+  table.sort();
 }
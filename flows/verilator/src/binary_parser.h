@@ -5,23 +5,67 @@
 #ifndef BINARY_PARSER_H
 #define BINARY_PARSER_H
 
+#include <elf.h>
+#include <string>
+#include <vector>
+#include "symbol_table.h"
 #include "types.h"
 
 class MainMemory;
 
+// Reader for RISC-V ELF executables. The file is mapped into memory once, and
+// all queries are answered from the mapping.
 class BinaryParser {
 
 public:
 
-  // Load the contents of a RISC-V executable and its arguments into `memory`.
-  static void load_elf(int argc, char** argv, MainMemory& memory);
+  // Map the named file. Throws if it can't be read or is not a 64-bit RISC-V
+  // ELF.
+  BinaryParser(const char* filename);
+  ~BinaryParser();
 
-  // Determine the memory address of the first instruction to be executed in the
-  // given program.
-  static MemoryAddress entry_point(char* filename);
+  BinaryParser(const BinaryParser&) = delete;
+  BinaryParser& operator=(const BinaryParser&) = delete;
 
-  // Get the memory address to which the named symbol is mapped.
-  static MemoryAddress symbol_location(char* filename, std::string symbol);
+  // Load the contents of the executable into `memory`.
+  void load(MainMemory& memory) const;
+
+  // Build the program's initial stack below `stack_top`: argc, argv, envp and
+  // the auxiliary vector, followed by the strings they point to. argv[0] is
+  // the executable's name and each element of `envp` is "NAME=value". Returns
+  // the initial stack pointer, which points to argc.
+  MemoryAddress write_stack(int argc, char** argv,
+                            const std::vector<std::string>& envp,
+                            MemoryAddress stack_top, MainMemory& memory) const;
+
+  // Determine the memory address of the first instruction to be executed.
+  MemoryAddress entry_point() const;
+
+  // The first address after all loaded sections, including uninitialised
+  // data. This is where the heap begins.
+  MemoryAddress end_address() const;
+
+  // Replace the contents of `table` with this executable's symbols.
+  void read_symbols(SymbolTable& table) const;
+
+private:
+
+  // Pointer to `length` bytes at `offset` in the file. Throws if the range is
+  // outside the file.
+  const char* contents(uint64_t offset, uint64_t length) const;
+
+  const Elf64_Ehdr& elf_header() const;
+
+  // Address of the program headers once loaded into memory, or 0 if they are
+  // not in a loaded segment.
+  MemoryAddress program_headers_address() const;
+
+  const Elf64_Shdr& section_header(int section) const;
+
+  std::string filename;
+
+  char*  data;
+  size_t size;
 
 };
 
@@ -0,0 +1,190 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <iomanip>
+
+#include "branch_statistics.h"
+
+using std::setw;
+
+// Always ensure these match the predictor parameters in muntjac_frontend.sv
+// and muntjac_ras.sv.
+const predictor_config_t BranchStatistics::DEFAULT_CONFIG = {9, 6, 8};
+
+static const char* branch_type_name(branch_type_e type) {
+  switch (type) {
+    case BRANCH_UNTAKEN:
+    case BRANCH_TAKEN:  return "branch";
+    case BRANCH_JUMP:   return "jump";
+    case BRANCH_CALL:   return "call";
+    case BRANCH_RET:    return "return";
+    case BRANCH_YIELD:  return "yield";
+    default:            return "other";
+  }
+}
+
+BranchStatistics::BranchStatistics() {
+  clear();
+}
+
+void BranchStatistics::clear() {
+  branches.clear();
+
+  // Vary one predictor at a time around the default configuration.
+  const predictor_config_t& d = DEFAULT_CONFIG;
+  models.clear();
+  models.emplace_back(d);
+  for (int bits=d.bht_index_bits-2; bits<=d.bht_index_bits+3; bits++)
+    if (bits != d.bht_index_bits)
+      models.emplace_back(predictor_config_t{bits, d.btb_index_bits, d.ras_entries});
+  for (int bits=d.btb_index_bits-2; bits<=d.btb_index_bits+3; bits++)
+    if (bits != d.btb_index_bits)
+      models.emplace_back(predictor_config_t{d.bht_index_bits, bits, d.ras_entries});
+  for (int entries : {2, 4, 16, 32})
+    models.emplace_back(predictor_config_t{d.bht_index_bits, d.btb_index_bits, entries});
+}
+
+void BranchStatistics::resolve(MemoryAddress pc, branch_type_e type,
+                               MemoryAddress target) {
+  branch_stats_t& stats = branches[pc];
+  stats.type = type;
+  stats.executed++;
+  if (is_taken(type))
+    stats.taken++;
+
+  for (PredictorModel& model : models)
+    model.resolve(pc, type, target);
+}
+
+void BranchStatistics::mispredict(MemoryAddress pc, bool predicted) {
+  // Mispredictions are reported after the branch is resolved, so the type is
+  // known. If not, a non-branch instruction was mistaken for a branch.
+  branch_stats_t& stats = branches[pc];
+  stats.mispredicted++;
+
+  if (!predicted && is_taken(stats.type))
+    stats.btb_miss++;
+  else if (predicted && (stats.type == BRANCH_RET || stats.type == BRANCH_YIELD))
+    stats.ras_mispredict++;
+}
+
+// Two-bit counter update, matching muntjac_bp_bimodal. The MSB gives the
+// prediction.
+static uint8_t train_bimodal(uint8_t state, bool taken) {
+  switch (state) {
+    case 0:  return taken ? 2 : 1;
+    case 1:  return taken ? 0 : 1;
+    case 2:  return taken ? 3 : 0;
+    default: return taken ? 3 : 2;
+  }
+}
+
+BranchStatistics::PredictorModel::PredictorModel(
+    const predictor_config_t& config) :
+    config(config),
+    mispredicts(0),
+    bht(1 << config.bht_index_bits, 0),
+    btb(1 << config.btb_index_bits, {false, 0, 0, BRANCH_NONE}),
+    ras(config.ras_entries, 0),
+    ras_top(0) {
+  // Nothing.
+}
+
+void BranchStatistics::PredictorModel::resolve(MemoryAddress pc,
+                                               branch_type_e type,
+                                               MemoryAddress target) {
+  uint64_t bht_mask = (1 << config.bht_index_bits) - 1;
+  uint64_t btb_mask = (1 << config.btb_index_bits) - 1;
+
+  uint8_t& counter = bht[(pc >> 2) & bht_mask];
+  btb_entry_t& entry = btb[(pc >> 2) & btb_mask];
+  bool btb_hit = entry.valid && entry.tag == (pc >> (2 + config.btb_index_bits));
+
+  // Predict. The call's size is unknown, so a return matches either address
+  // following it.
+  bool predict_taken = btb_hit && (entry.type >= BRANCH_JUMP || (counter >> 1));
+  bool target_correct;
+  if (btb_hit && (entry.type == BRANCH_RET || entry.type == BRANCH_YIELD)) {
+    MemoryAddress call = ras[ras_top];
+    target_correct = (target == call + 2) || (target == call + 4);
+  }
+  else
+    target_correct = entry.target == target;
+
+  bool taken = is_taken(type);
+  bool correct = taken ? (predict_taken && target_correct) : !predict_taken;
+
+  // Update.
+  if (!correct)
+    mispredicts++;
+
+  if (type == BRANCH_TAKEN || type == BRANCH_UNTAKEN)
+    counter = train_bimodal(counter, taken);
+
+  // The BTB is only trained on mispredicted taken branches.
+  if (taken && !correct)
+    entry = {true, pc >> (2 + config.btb_index_bits), target, type};
+
+  if (type == BRANCH_RET || type == BRANCH_YIELD)
+    ras_top = (ras_top + ras.size() - 1) % ras.size();
+  if (type == BRANCH_CALL || type == BRANCH_YIELD) {
+    ras_top = (ras_top + 1) % ras.size();
+    ras[ras_top] = pc;
+  }
+}
+
+void BranchStatistics::print_report(std::ostream& os,
+                                    const SymbolTable& symbols,
+                                    int num_branches) const {
+  uint64_t executed = 0;
+  uint64_t mispredicted = 0;
+  vector<MemoryAddress> worst;
+
+  for (auto& branch : branches) {
+    executed += branch.second.executed;
+    mispredicted += branch.second.mispredicted;
+    if (branch.second.mispredicted > 0)
+      worst.push_back(branch.first);
+  }
+
+  std::sort(worst.begin(), worst.end(),
+    [this](MemoryAddress a, MemoryAddress b) {
+      return branches.at(a).mispredicted > branches.at(b).mispredicted;
+    }
+  );
+  if (worst.size() > (size_t)num_branches)
+    worst.resize(num_branches);
+
+  os << "Branch prediction: " << executed << " jumps/branches, "
+     << mispredicted << " mispredicted\n";
+
+  os << "  " << std::left << setw(18) << "pc" << setw(32) << "location"
+     << setw(8) << "type" << std::right << setw(12) << "executed"
+     << setw(12) << "taken" << setw(12) << "mispredict" << setw(12)
+     << "btb miss" << setw(12) << "ras miss" << "\n";
+
+  for (MemoryAddress pc : worst) {
+    const branch_stats_t& stats = branches.at(pc);
+    os << "  0x" << std::left << std::hex << setw(16) << pc << std::dec
+       << setw(32) << symbols.describe(pc).substr(0, 31)
+       << setw(8) << (stats.executed > 0 ? branch_type_name(stats.type) : "none")
+       << std::right << setw(12) << stats.executed << setw(12) << stats.taken
+       << setw(12) << stats.mispredicted << setw(12) << stats.btb_miss
+       << setw(12) << stats.ras_mispredict << "\n";
+  }
+
+  os << "Estimated mispredictions with other predictor sizes (software model):\n";
+  os << "  " << setw(12) << "BHT entries" << setw(12) << "BTB entries"
+     << setw(12) << "RAS entries" << setw(12) << "mispredict" << "\n";
+
+  for (size_t i=0; i<models.size(); i++) {
+    const predictor_config_t& config = models[i].config;
+    os << "  " << setw(12) << (1 << config.bht_index_bits)
+       << setw(12) << (1 << config.btb_index_bits)
+       << setw(12) << config.ras_entries
+       << setw(12) << models[i].mispredicts
+       << (i == 0 ? "  (current)" : "") << "\n";
+  }
+}
@@ -0,0 +1,143 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Measure the accuracy of the core's branch predictors, and estimate how
+// accuracy would change with different predictor sizes.
+
+#ifndef BRANCH_STATISTICS_H
+#define BRANCH_STATISTICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "symbol_table.h"
+#include "types.h"
+
+using std::unordered_map;
+using std::vector;
+
+// Always ensure this matches branch_type_e in muntjac_pkg.sv.
+typedef enum {
+  BRANCH_NONE    = 0,
+  BRANCH_UNTAKEN = 2,
+  BRANCH_TAKEN   = 3,
+  BRANCH_JUMP    = 4,
+  BRANCH_CALL    = 5,
+  BRANCH_RET     = 6,
+  BRANCH_YIELD   = 7
+} branch_type_e;
+
+// Information about branches, from the core's debug outputs.
+typedef struct {
+  // A jump or branch was resolved this cycle.
+  bool          resolved;
+  branch_type_e type;
+
+  // The most recently issued instruction, and the instruction to follow it.
+  MemoryAddress pc;
+  MemoryAddress target;
+
+  // The instruction following `pc` was fetched from the wrong address.
+  bool          mispredict;
+  // The wrong instruction came from a predicted target rather than
+  // sequential fetch.
+  bool          predicted;
+} branch_trace_t;
+
+// Predictor sizes, as log2(entries) for the indexed tables.
+typedef struct {
+  int bht_index_bits;
+  int btb_index_bits;
+  int ras_entries;
+} predictor_config_t;
+
+class BranchStatistics {
+public:
+
+  BranchStatistics();
+
+  void clear();
+
+  // Called once per clock cycle. Defined here so it can be inlined into the
+  // simulation loop.
+  void sample(const branch_trace_t& trace) {
+    if (trace.resolved)
+      resolve(trace.pc, trace.type, trace.target);
+    if (trace.mispredict)
+      mispredict(trace.pc, trace.predicted);
+  }
+
+  // A jump or branch at `pc` was resolved. `target` is the address of the next
+  // instruction to execute.
+  void resolve(MemoryAddress pc, branch_type_e type, MemoryAddress target);
+
+  // The instruction following `pc` was fetched from the wrong address.
+  // `predicted` is set if the frontend redirected fetch to a predicted target.
+  void mispredict(MemoryAddress pc, bool predicted);
+
+  // Print the branches with most mispredictions, followed by an estimate of
+  // the mispredictions with alternative predictor sizes.
+  void print_report(std::ostream& os, const SymbolTable& symbols,
+                    int num_branches) const;
+
+  // The sizes used by muntjac_frontend.
+  static const predictor_config_t DEFAULT_CONFIG;
+
+private:
+
+  typedef struct {
+    branch_type_e type;
+    uint64_t executed;
+    uint64_t taken;
+    uint64_t mispredicted;
+
+    // Taken, but fetch continued sequentially: the BTB had no entry, or the
+    // direction predictor said not-taken.
+    uint64_t btb_miss;
+
+    // A return was predicted, but to the wrong address.
+    uint64_t ras_mispredict;
+  } branch_stats_t;
+
+  // Software model of the predictors at one size, fed every resolved branch
+  // as it happens so no branch history needs to be kept.
+  class PredictorModel {
+  public:
+    PredictorModel(const predictor_config_t& config);
+
+    void resolve(MemoryAddress pc, branch_type_e type, MemoryAddress target);
+
+    const predictor_config_t config;
+    uint64_t mispredicts;
+
+  private:
+    typedef struct {
+      bool          valid;
+      MemoryAddress tag;
+      MemoryAddress target;
+      branch_type_e type;
+    } btb_entry_t;
+
+    vector<uint8_t> bht;
+    vector<btb_entry_t> btb;
+
+    // Circular return address stack holding the PCs of call instructions.
+    vector<MemoryAddress> ras;
+    size_t ras_top;
+  };
+
+  static bool is_taken(branch_type_e type) {
+    return type == BRANCH_TAKEN || type >= BRANCH_JUMP;
+  }
+
+  unordered_map<MemoryAddress, branch_stats_t> branches;
+
+  // The default configuration first, then variations around it.
+  vector<PredictorModel> models;
+
+};
+
+#endif  // BRANCH_STATISTICS_H
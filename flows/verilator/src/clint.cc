@@ -0,0 +1,91 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "clint.h"
+
+// Register offsets. Only hart 0 is supported.
+#define CLINT_MSIP      0x0000
+#define CLINT_MTIMECMP  0x4000
+#define CLINT_MTIME     0xbff8
+
+// Replace the bytes of `original` accessed by a write of `num_bytes` at
+// `offset` within a 64-bit register.
+static uint64_t merge(uint64_t original, uint64_t data, MemoryAddress offset,
+                      int num_bytes) {
+  if (num_bytes >= 8)
+    return data;
+
+  int shift = (offset & 7) * 8;
+  uint64_t mask = ((1ULL << (num_bytes * 8)) - 1) << shift;
+  return (original & ~mask) | ((data << shift) & mask);
+}
+
+Clint::Clint() :
+    MemoryMappedDevice(DEFAULT_ADDRESS, 0x10000) {
+  timebase = 1;
+  now = 0;
+  reset();
+}
+
+void Clint::set_timebase(uint64_t cycles) {
+  timebase = (cycles == 0) ? 1 : cycles;
+  update_deadline();
+}
+
+void Clint::reset() {
+  start_cycle = now;
+  mtime_offset = 0;
+  mtimecmp = UINT64_MAX;
+  msip = false;
+  update_deadline();
+}
+
+uint64_t Clint::mtime() const {
+  return mtime_offset + (now - start_cycle) / timebase;
+}
+
+void Clint::set_mtime(uint64_t value) {
+  start_cycle = now;
+  mtime_offset = value;
+}
+
+void Clint::update_deadline() {
+  if (mtimecmp <= mtime_offset)
+    timer_deadline = start_cycle;
+  else if ((mtimecmp - mtime_offset) > (UINT64_MAX - start_cycle) / timebase)
+    timer_deadline = UINT64_MAX;
+  else
+    timer_deadline = start_cycle + (mtimecmp - mtime_offset) * timebase;
+}
+
+uint64_t Clint::read(MemoryAddress offset, int /*num_bytes*/) {
+  // Accesses may be to either half of a 64-bit register.
+  int shift = (offset & 7) * 8;
+
+  switch (offset & ~7) {
+    case CLINT_MSIP:     return msip ? 1 : 0;
+    case CLINT_MTIMECMP: return mtimecmp >> shift;
+    case CLINT_MTIME:    return mtime() >> shift;
+    default:             return 0;
+  }
+}
+
+void Clint::write(MemoryAddress offset, uint64_t data, int num_bytes) {
+  switch (offset & ~7) {
+    case CLINT_MSIP:
+      if ((offset & 7) == 0)
+        msip = data & 1;
+      break;
+    case CLINT_MTIMECMP:
+      mtimecmp = merge(mtimecmp, data, offset, num_bytes);
+      update_deadline();
+      break;
+    case CLINT_MTIME:
+      set_mtime(merge(mtime(), data, offset, num_bytes));
+      update_deadline();
+      break;
+    default:
+      break;
+  }
+}
@@ -0,0 +1,59 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Core-local interruptor: the machine timer (`mtime`, `mtimecmp`) and
+// software interrupt (`msip`) registers, in the SiFive CLINT layout.
+
+#ifndef CLINT_H
+#define CLINT_H
+
+#include <cstdint>
+#include "memory_mapped_device.h"
+
+class Clint : public MemoryMappedDevice {
+public:
+
+  static const MemoryAddress DEFAULT_ADDRESS = 0x02000000;
+
+  Clint();
+
+  // `mtime` increments once every `cycles` clock cycles.
+  void set_timebase(uint64_t cycles);
+
+  // Called once per clock cycle. Defined here so it can be inlined into the
+  // simulation loop.
+  void tick(uint64_t cycle) {
+    now = cycle;
+  }
+
+  virtual uint64_t read(MemoryAddress offset, int num_bytes);
+  virtual void write(MemoryAddress offset, uint64_t data, int num_bytes);
+  virtual void reset();
+
+  // Interrupts requested, as a bitmask in the layout of `mip`.
+  uint32_t pending_interrupts() const {
+    return (msip ? (1 << 3) : 0) | ((now >= timer_deadline) ? (1 << 7) : 0);
+  }
+
+private:
+
+  uint64_t mtime() const;
+  void set_mtime(uint64_t value);
+
+  // Recompute the cycle when the timer interrupt fires.
+  void update_deadline();
+
+  uint64_t timebase;
+
+  uint64_t now;
+  uint64_t start_cycle;
+  uint64_t mtime_offset;  // Value of `mtime` at `start_cycle`.
+
+  uint64_t mtimecmp;
+  uint64_t timer_deadline;
+  bool msip;
+
+};
+
+#endif  // CLINT_H
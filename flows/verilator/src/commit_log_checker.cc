@@ -0,0 +1,218 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include "commit_log_checker.h"
+#include "logs.h"
+#include "register_names.h"
+
+using std::stringstream;
+
+// Split one line of CSV, respecting quotes.
+static vector<string> split_csv(const string& line) {
+  vector<string> fields(1);
+  bool quoted = false;
+
+  for (size_t i=0; i<line.size(); i++) {
+    char c = line[i];
+
+    if (c == '"') {
+      if (quoted && i + 1 < line.size() && line[i + 1] == '"')
+        fields.back() += line[++i];
+      else
+        quoted = !quoted;
+    }
+    else if (c == ',' && !quoted)
+      fields.emplace_back();
+    else if (c != '\r')
+      fields.back() += c;
+  }
+
+  return fields;
+}
+
+static bool parse_hex(const string& text, uint64_t& value) {
+  if (text.empty())
+    return false;
+
+  char* end;
+  value = std::strtoull(text.c_str(), &end, 16);
+  return *end == '\0';
+}
+
+// Parse a list of register updates, "name:value;name:value", and compare with
+// a single update (or none, if `name` is NULL).
+static bool updates_match(const string& text, const char* name,
+                          uint64_t value) {
+  if (name == NULL)
+    return false;
+
+  size_t colon = text.find(':');
+  uint64_t expected;
+  return colon != string::npos &&
+         text.find(';') == string::npos &&
+         text.compare(0, colon, name) == 0 &&
+         parse_hex(text.substr(colon + 1), expected) &&
+         expected == value;
+}
+
+CommitLogChecker::CommitLogChecker() {
+  finished = false;
+  checked = 0;
+}
+
+void CommitLogChecker::open(string filename) {
+  this->filename = filename;
+  reference.open(filename);
+
+  if (!reference.good()) {
+    MUNTJAC_ERROR << "Unable to read reference trace from " << filename << endl;
+    exit(1);
+  }
+
+  // Header row.
+  column_pc = column_instr = column_gpr = column_csr = -1;
+  column_binary = column_mode = column_instr_str = -1;
+
+  if (next_row()) {
+    for (size_t i=0; i<row.size(); i++) {
+      if (row[i] == "pc")             column_pc = i;
+      else if (row[i] == "instr")     column_instr = i;
+      else if (row[i] == "gpr")       column_gpr = i;
+      else if (row[i] == "csr")       column_csr = i;
+      else if (row[i] == "binary")    column_binary = i;
+      else if (row[i] == "mode")      column_mode = i;
+      else if (row[i] == "instr_str") column_instr_str = i;
+    }
+  }
+
+  if (column_pc < 0 || column_binary < 0) {
+    MUNTJAC_ERROR << filename << " is not a riscv-dv trace: expected pc and "
+                  << "binary columns" << endl;
+    exit(1);
+  }
+
+  finished = false;
+  checked = 0;
+  history.clear();
+}
+
+bool CommitLogChecker::next_row() {
+  if (!std::getline(reference, row_text))
+    return false;
+
+  row = split_csv(row_text);
+  return true;
+}
+
+const string& CommitLogChecker::field(int column) const {
+  static const string empty;
+  return (column >= 0 && (size_t)column < row.size()) ? row[column] : empty;
+}
+
+bool CommitLogChecker::check(const instr_trace_t& trace) {
+  if (finished)
+    return true;
+
+  if (!next_row()) {
+    MUNTJAC_LOG(1) << "Reference trace ended after " << checked
+                   << " instructions" << endl;
+    finished = true;
+    return true;
+  }
+
+  // riscv-dv's Spike log parser discards everything after an `ecall`.
+  if (field(column_instr) == "ecall") {
+    MUNTJAC_LOG(1) << "Reference trace reached ecall after " << checked
+                   << " instructions" << endl;
+    finished = true;
+    return true;
+  }
+
+  history.push_back({row_text, format(trace)});
+  if (history.size() > CONTEXT_LINES)
+    history.pop_front();
+
+  mismatch = compare(trace);
+  if (!mismatch.empty())
+    return false;
+
+  checked++;
+  return true;
+}
+
+string CommitLogChecker::compare(const instr_trace_t& trace) const {
+  uint64_t value;
+
+  const string& pc = field(column_pc);
+  if (!parse_hex(pc, value) || value != trace.pc)
+    return "pc";
+
+  // Spike may display 64-bit instructions in full, but Muntjac doesn't load
+  // them.
+  const string& binary = field(column_binary);
+  if (!parse_hex(binary, value) || value != trace.instr_word) {
+    stringstream word;
+    word << std::hex << std::setfill('0') << std::setw(8) << trace.instr_word;
+    if (binary.find(word.str()) == string::npos)
+      return "binary";
+  }
+
+  // OVPsim doesn't output a register update if the value didn't change.
+  const string& gpr = field(column_gpr);
+  if (!gpr.empty()) {
+    bool written = trace.gpr_written && trace.gpr != 0;
+    if (!updates_match(gpr, written ? gpr_name(trace.gpr) : NULL, trace.gpr_data))
+      return "gpr";
+  }
+
+  // Spike doesn't output any CSR updates.
+  const string& csr = field(column_csr);
+  if (!csr.empty()) {
+    string name = csr_name(trace.csr);
+    if (!updates_match(csr, trace.csr_written ? name.c_str() : NULL, trace.csr_data))
+      return "csr";
+  }
+
+  // Spike doesn't output a mode when no state is updated.
+  const string& mode = field(column_mode);
+  if (!mode.empty() && std::strtol(mode.c_str(), NULL, 10) != trace.mode)
+    return "mode";
+
+  return "";
+}
+
+string CommitLogChecker::format(const instr_trace_t& trace) {
+  stringstream ss;
+  ss << std::hex << std::setfill('0');
+
+  ss << std::setw(16) << trace.pc << ",";
+  if (trace.gpr_written && trace.gpr != 0)
+    ss << gpr_name(trace.gpr) << ":" << std::setw(16) << trace.gpr_data;
+  ss << ",";
+  if (trace.csr_written)
+    ss << csr_name(trace.csr) << ":" << std::setw(16) << trace.csr_data;
+  ss << ",";
+  ss << std::setw(8) << trace.instr_word << ",";
+  ss << std::dec << trace.mode;
+
+  return ss.str();
+}
+
+void CommitLogChecker::print_divergence(std::ostream& os) const {
+  os << "Divergence from " << filename << " at instruction " << checked
+     << ": " << mismatch << " differs";
+  if (column_instr_str >= 0)
+    os << " (expected " << field(column_instr_str) << ")";
+  os << "\n";
+
+  os << "Recent instructions (reference, then Muntjac's pc,gpr,csr,binary,mode):\n";
+  for (auto& entry : history) {
+    os << "  ref:     " << entry.first << "\n";
+    os << "  muntjac: " << entry.second << "\n";
+  }
+}
@@ -0,0 +1,97 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Compare each instruction as it retires against a reference simulator's
+// trace, instead of comparing complete traces after the simulation ends.
+
+#ifndef COMMIT_LOG_CHECKER_H
+#define COMMIT_LOG_CHECKER_H
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+using std::deque;
+using std::string;
+using std::vector;
+
+// The reference trace uses riscv-dv's CSV format (as produced by
+// spike_log_to_trace_csv.py), and is read one line at a time, so may be a
+// named pipe fed by a reference simulator running alongside. The comparison
+// rules match muntjac_trace_compare.py.
+class CommitLogChecker {
+public:
+
+  CommitLogChecker();
+
+  // Start reading a reference trace. Exits with an error if the file can't be
+  // opened or doesn't have the expected columns.
+  void open(string filename);
+
+  bool is_open() const {
+    return reference.is_open();
+  }
+
+  // Compare the next retired instruction with the reference. Returns false at
+  // the first divergence. Once the reference trace ends, or reaches an
+  // `ecall` (after which riscv-dv discards the trace), everything matches.
+  bool check(const instr_trace_t& trace);
+
+  // Describe the most recent divergence, with the instructions leading up to
+  // it.
+  void print_divergence(std::ostream& os) const;
+
+  // Instructions compared so far.
+  uint64_t instructions_checked() const {
+    return checked;
+  }
+
+private:
+
+  // Read the next line of the reference trace. Returns false at the end.
+  bool next_row();
+
+  // The first field in which `trace` differs from the current reference row,
+  // or "" if they match.
+  string compare(const instr_trace_t& trace) const;
+
+  const string& field(int column) const;
+
+  // `trace` formatted like a row of the reference trace.
+  static string format(const instr_trace_t& trace);
+
+  string filename;
+  std::ifstream reference;
+
+  // Column indices in the reference trace, or -1 if absent.
+  int column_pc;
+  int column_instr;
+  int column_gpr;
+  int column_csr;
+  int column_binary;
+  int column_mode;
+  int column_instr_str;
+
+  vector<string> row;
+  string row_text;
+
+  // The reference has ended, so there is nothing left to compare.
+  bool finished;
+
+  uint64_t checked;
+
+  // Recent instructions: reference row, followed by Muntjac's equivalent.
+  static const size_t CONTEXT_LINES = 8;
+  deque<std::pair<string, string>> history;
+
+  string mismatch;
+
+};
+
+#endif  // COMMIT_LOG_CHECKER_H
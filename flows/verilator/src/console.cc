@@ -0,0 +1,83 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cinttypes>
+#include <fstream>
+#include <iterator>
+
+#include "console.h"
+#include "logs.h"
+
+Console::Console() {
+  output = stdout;
+  timestamps = false;
+  line_start = true;
+  input_position = 0;
+}
+
+Console::~Console() {
+  flush();
+
+  if (output != stdout)
+    fclose(output);
+}
+
+void Console::set_output(string filename) {
+  FILE* file = fopen(filename.c_str(), "w");
+
+  if (file == NULL) {
+    MUNTJAC_ERROR << "Unable to open console output file " << filename << endl;
+    exit(1);
+  }
+
+  if (output != stdout)
+    fclose(output);
+
+  output = file;
+  setvbuf(output, NULL, _IOFBF, 1 << 16);
+}
+
+void Console::set_timestamps(bool enable) {
+  timestamps = enable;
+}
+
+void Console::set_input(string filename) {
+  std::ifstream file(filename, std::ios::binary);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to read console input from " << filename << endl;
+    exit(1);
+  }
+
+  input.assign(std::istreambuf_iterator<char>(file),
+               std::istreambuf_iterator<char>());
+  input_position = 0;
+}
+
+void Console::put(char c) {
+  if (timestamps && line_start)
+    fprintf(output, "[cycle %" PRIu64 "] ", (uint64_t)sc_time_stamp());
+
+  fputc(c, output);
+  line_start = (c == '\n');
+}
+
+void Console::flush() {
+  fflush(output);
+}
+
+bool Console::has_input() const {
+  return input_position < input.size();
+}
+
+char Console::get() {
+  if (!has_input())
+    return 0;
+
+  return input[input_position++];
+}
+
+void Console::rewind_input() {
+  input_position = 0;
+}
@@ -0,0 +1,56 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Host side of the simulated program's console: buffered output, optionally
+// to a file, and scripted input.
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <cstdio>
+#include <string>
+
+using std::string;
+
+class Console {
+public:
+
+  // Output goes to stdout by default.
+  Console();
+  ~Console();
+
+  // Send output to the named file instead of stdout.
+  void set_output(string filename);
+
+  // Prefix each line of output with the cycle when it started.
+  void set_timestamps(bool enable);
+
+  // Supply the program's input from the named file.
+  void set_input(string filename);
+
+  // Output a character from the program.
+  void put(char c);
+
+  // Make sure all output so far has been written.
+  void flush();
+
+  // Input for the program.
+  bool has_input() const;
+  char get();
+
+  // Start the input again from the beginning, e.g. for a new program.
+  void rewind_input();
+
+private:
+
+  FILE* output;
+  bool timestamps;
+  bool line_start;
+
+  string input;
+  size_t input_position;
+
+};
+
+#endif  // CONSOLE_H
@@ -92,8 +92,27 @@ protected:
     uint64_t data_read = 0;
     uint64_t data_write = dut.io_wdata_o;
 
-    // Data read.
-    data_read = memory.read64(address);
+    // Data read. Device registers may have side effects when read, so only
+    // read the bytes requested.
+    if (!dut.io_we_o) {
+      switch (dut.io_wmask_o) {
+        case 0b00000001: data_read = (uint64_t)memory.read8(address + 0) << 0; break;
+        case 0b00000010: data_read = (uint64_t)memory.read8(address + 1) << 8; break;
+        case 0b00000100: data_read = (uint64_t)memory.read8(address + 2) << 16; break;
+        case 0b00001000: data_read = (uint64_t)memory.read8(address + 3) << 24; break;
+        case 0b00010000: data_read = (uint64_t)memory.read8(address + 4) << 32; break;
+        case 0b00100000: data_read = (uint64_t)memory.read8(address + 5) << 40; break;
+        case 0b01000000: data_read = (uint64_t)memory.read8(address + 6) << 48; break;
+        case 0b10000000: data_read = (uint64_t)memory.read8(address + 7) << 56; break;
+        case 0b00000011: data_read = (uint64_t)memory.read16(address + 0) << 0; break;
+        case 0b00001100: data_read = (uint64_t)memory.read16(address + 2) << 16; break;
+        case 0b00110000: data_read = (uint64_t)memory.read16(address + 4) << 32; break;
+        case 0b11000000: data_read = (uint64_t)memory.read16(address + 6) << 48; break;
+        case 0b00001111: data_read = (uint64_t)memory.read32(address + 0) << 0; break;
+        case 0b11110000: data_read = (uint64_t)memory.read32(address + 4) << 32; break;
+        default:         data_read = memory.read64(address); break;
+      }
+    }
 
     // Data write.
     if (dut.io_we_o) {
@@ -110,8 +129,8 @@ protected:
         case 0b00001100: memory.write16(address + 2, (uint16_t)(data_write >> 16)); break;
         case 0b00110000: memory.write16(address + 4, (uint16_t)(data_write >> 32)); break;
         case 0b11000000: memory.write16(address + 6, (uint16_t)(data_write >> 48)); break;
-        case 0b00001111: memory.write32(address + 0, (uint16_t)(data_write >> 0)); break;
-        case 0b11110000: memory.write32(address + 4, (uint16_t)(data_write >> 32)); break;
+        case 0b00001111: memory.write32(address + 0, (uint32_t)(data_write >> 0)); break;
+        case 0b11110000: memory.write32(address + 4, (uint32_t)(data_write >> 32)); break;
         case 0b11111111: memory.write64(address, data_write); break;
         default:
           MUNTJAC_ERROR << "Unsupported memory write mask: " << dut.io_wmask_o << endl;
@@ -155,6 +174,37 @@ protected:
   virtual void set_reset(int value) {dut.rst_ni = !value;}
   virtual MemoryAddress get_program_counter() {return dut.dbg_pc_o;}
 
+  virtual uint32_t get_performance_events() {return dut.dbg_hpm_event_o;}
+
+  // Only tohost/fromhost and devices are uncached.
+  virtual bool has_data_cache() const {return true;}
+
+  virtual branch_trace_t get_branch_trace() {
+    branch_trace_t trace;
+    trace.resolved = dut.dbg_branch_resolved_o;
+    trace.type = (branch_type_e)dut.dbg_branch_type_o;
+    trace.pc = dut.dbg_branch_pc_o;
+    trace.target = dut.dbg_branch_target_o;
+    trace.mispredict = dut.dbg_branch_mispredict_o;
+    trace.predicted = dut.dbg_branch_predicted_o;
+    return trace;
+  }
+
+  virtual trap_trace_t get_trap_trace() {
+    trap_trace_t trace;
+    trace.valid = dut.dbg_trap_valid_o;
+    trace.cause = dut.dbg_trap_cause_o;
+    trace.tvec = dut.dbg_trap_tvec_o;
+    return trace;
+  }
+
+  virtual void set_interrupts(uint32_t pending) {
+    dut.irq_software_m_i = (pending >> 3) & 1;
+    dut.irq_timer_m_i = (pending >> 7) & 1;
+    dut.irq_external_s_i = (pending >> 9) & 1;
+    dut.irq_external_m_i = (pending >> 11) & 1;
+  }
+
   virtual instr_trace_t get_trace_info() {
     // The RTL must be compiled with TRACE_ENABLE to enable all of these.
     instr_trace_t trace;
@@ -183,6 +233,9 @@ protected:
     dut.irq_external_m_i = 0;
     dut.irq_external_s_i = 0; // sip[9]
     dut.hart_id_i = 0;
+
+    main_memory_port.reset();
+    io_memory_port.reset();
   }
 
   // The timing requirements are delicate. In each cycle, we have:
@@ -201,14 +254,14 @@ protected:
   // In order to achieve a single-cycle cache latency, we need:
   //   posedge eval -> get_inputs -> set_outputs -> posedge eval
   virtual void cycle_first_half() {
-    dut.eval();
+    eval();
 
     main_memory_port.set_outputs(simulation_time());
     io_memory_port.set_outputs(simulation_time());
   }
 
   virtual void cycle_second_half() {
-    dut.eval();
+    eval();
 
     main_memory_port.get_inputs(simulation_time());
     io_memory_port.get_inputs(simulation_time());
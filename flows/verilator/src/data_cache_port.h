@@ -29,6 +29,12 @@ public:
     clear_all_reservations();
   }
 
+  virtual void reset() {
+    MemoryPort<uint64_t>::reset();
+    delayed_notif_ready = 0;
+    clear_all_reservations();
+  }
+
 protected:
 
   virtual bool can_receive_request() {
@@ -0,0 +1,513 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <array>
+#include <sstream>
+#include <vector>
+
+#include "disassembler.h"
+#include "register_names.h"
+
+using std::to_string;
+using std::vector;
+
+// How to display an instruction's operands.
+typedef enum {
+  FMT_NONE,    //
+  FMT_R,       // rd, rs1, rs2
+  FMT_I,       // rd, rs1, imm
+  FMT_SHIFT,   // rd, rs1, shamt
+  FMT_LOAD,    // rd, imm(rs1)
+  FMT_STORE,   // rs2, imm(rs1)
+  FMT_BRANCH,  // rs1, rs2, pc + offset
+  FMT_U,       // rd, imm
+  FMT_JAL,     // rd, pc + offset
+  FMT_CSR,     // rd, csr, rs1
+  FMT_CSRI,    // rd, csr, uimm
+  FMT_FENCE,   // pred, succ
+  FMT_AMO,     // rd, rs2, (rs1)
+  FMT_LR,      // rd, (rs1)
+  FMT_SFENCE,  // rs1, rs2
+  FMT_FLOAD,   // frd, imm(rs1)
+  FMT_FSTORE,  // frs2, imm(rs1)
+  FMT_FR,      // frd, frs1, frs2
+  FMT_FR1,     // frd, frs1
+  FMT_FR4,     // frd, frs1, frs2, frs3
+  FMT_FCMP,    // rd, frs1, frs2
+  FMT_F2X,     // rd, frs1
+  FMT_X2F      // frd, rs1
+} format_e;
+
+typedef struct {
+  uint32_t    mask;
+  uint32_t    match;
+  const char* name;
+  format_e    format;
+} opcode_t;
+
+// Masks and values from riscv-opcodes. Fields which only affect rounding or
+// memory ordering are excluded from the masks.
+static const opcode_t opcodes[] = {
+  // RV64I
+  {0x0000007f, 0x00000037, "lui",        FMT_U},
+  {0x0000007f, 0x00000017, "auipc",      FMT_U},
+  {0x0000007f, 0x0000006f, "jal",        FMT_JAL},
+  {0x0000707f, 0x00000067, "jalr",       FMT_LOAD},
+  {0x0000707f, 0x00000063, "beq",        FMT_BRANCH},
+  {0x0000707f, 0x00001063, "bne",        FMT_BRANCH},
+  {0x0000707f, 0x00004063, "blt",        FMT_BRANCH},
+  {0x0000707f, 0x00005063, "bge",        FMT_BRANCH},
+  {0x0000707f, 0x00006063, "bltu",       FMT_BRANCH},
+  {0x0000707f, 0x00007063, "bgeu",       FMT_BRANCH},
+  {0x0000707f, 0x00000003, "lb",         FMT_LOAD},
+  {0x0000707f, 0x00001003, "lh",         FMT_LOAD},
+  {0x0000707f, 0x00002003, "lw",         FMT_LOAD},
+  {0x0000707f, 0x00003003, "ld",         FMT_LOAD},
+  {0x0000707f, 0x00004003, "lbu",        FMT_LOAD},
+  {0x0000707f, 0x00005003, "lhu",        FMT_LOAD},
+  {0x0000707f, 0x00006003, "lwu",        FMT_LOAD},
+  {0x0000707f, 0x00000023, "sb",         FMT_STORE},
+  {0x0000707f, 0x00001023, "sh",         FMT_STORE},
+  {0x0000707f, 0x00002023, "sw",         FMT_STORE},
+  {0x0000707f, 0x00003023, "sd",         FMT_STORE},
+  {0x0000707f, 0x00000013, "addi",       FMT_I},
+  {0x0000707f, 0x00002013, "slti",       FMT_I},
+  {0x0000707f, 0x00003013, "sltiu",      FMT_I},
+  {0x0000707f, 0x00004013, "xori",       FMT_I},
+  {0x0000707f, 0x00006013, "ori",        FMT_I},
+  {0x0000707f, 0x00007013, "andi",       FMT_I},
+  {0xfc00707f, 0x00001013, "slli",       FMT_SHIFT},
+  {0xfc00707f, 0x00005013, "srli",       FMT_SHIFT},
+  {0xfc00707f, 0x40005013, "srai",       FMT_SHIFT},
+  {0xfe00707f, 0x00000033, "add",        FMT_R},
+  {0xfe00707f, 0x40000033, "sub",        FMT_R},
+  {0xfe00707f, 0x00001033, "sll",        FMT_R},
+  {0xfe00707f, 0x00002033, "slt",        FMT_R},
+  {0xfe00707f, 0x00003033, "sltu",       FMT_R},
+  {0xfe00707f, 0x00004033, "xor",        FMT_R},
+  {0xfe00707f, 0x00005033, "srl",        FMT_R},
+  {0xfe00707f, 0x40005033, "sra",        FMT_R},
+  {0xfe00707f, 0x00006033, "or",         FMT_R},
+  {0xfe00707f, 0x00007033, "and",        FMT_R},
+  {0x0000707f, 0x0000001b, "addiw",      FMT_I},
+  {0xfe00707f, 0x0000101b, "slliw",      FMT_SHIFT},
+  {0xfe00707f, 0x0000501b, "srliw",      FMT_SHIFT},
+  {0xfe00707f, 0x4000501b, "sraiw",      FMT_SHIFT},
+  {0xfe00707f, 0x0000003b, "addw",       FMT_R},
+  {0xfe00707f, 0x4000003b, "subw",       FMT_R},
+  {0xfe00707f, 0x0000103b, "sllw",       FMT_R},
+  {0xfe00707f, 0x0000503b, "srlw",       FMT_R},
+  {0xfe00707f, 0x4000503b, "sraw",       FMT_R},
+  {0x0000707f, 0x0000000f, "fence",      FMT_FENCE},
+  {0x0000707f, 0x0000100f, "fence.i",    FMT_NONE},
+
+  // Privileged
+  {0xffffffff, 0x00000073, "ecall",      FMT_NONE},
+  {0xffffffff, 0x00100073, "ebreak",     FMT_NONE},
+  {0xffffffff, 0x00200073, "uret",       FMT_NONE},
+  {0xffffffff, 0x10200073, "sret",       FMT_NONE},
+  {0xffffffff, 0x30200073, "mret",       FMT_NONE},
+  {0xffffffff, 0x7b200073, "dret",       FMT_NONE},
+  {0xffffffff, 0x10500073, "wfi",        FMT_NONE},
+  {0xfe007fff, 0x12000073, "sfence.vma", FMT_SFENCE},
+  {0x0000707f, 0x00001073, "csrrw",      FMT_CSR},
+  {0x0000707f, 0x00002073, "csrrs",      FMT_CSR},
+  {0x0000707f, 0x00003073, "csrrc",      FMT_CSR},
+  {0x0000707f, 0x00005073, "csrrwi",     FMT_CSRI},
+  {0x0000707f, 0x00006073, "csrrsi",     FMT_CSRI},
+  {0x0000707f, 0x00007073, "csrrci",     FMT_CSRI},
+
+  // RV64M
+  {0xfe00707f, 0x02000033, "mul",        FMT_R},
+  {0xfe00707f, 0x02001033, "mulh",       FMT_R},
+  {0xfe00707f, 0x02002033, "mulhsu",     FMT_R},
+  {0xfe00707f, 0x02003033, "mulhu",      FMT_R},
+  {0xfe00707f, 0x02004033, "div",        FMT_R},
+  {0xfe00707f, 0x02005033, "divu",       FMT_R},
+  {0xfe00707f, 0x02006033, "rem",        FMT_R},
+  {0xfe00707f, 0x02007033, "remu",       FMT_R},
+  {0xfe00707f, 0x0200003b, "mulw",       FMT_R},
+  {0xfe00707f, 0x0200403b, "divw",       FMT_R},
+  {0xfe00707f, 0x0200503b, "divuw",      FMT_R},
+  {0xfe00707f, 0x0200603b, "remw",       FMT_R},
+  {0xfe00707f, 0x0200703b, "remuw",      FMT_R},
+
+  // RV64A
+  {0xf9f0707f, 0x1000202f, "lr.w",       FMT_LR},
+  {0xf800707f, 0x1800202f, "sc.w",       FMT_AMO},
+  {0xf800707f, 0x0800202f, "amoswap.w",  FMT_AMO},
+  {0xf800707f, 0x0000202f, "amoadd.w",   FMT_AMO},
+  {0xf800707f, 0x2000202f, "amoxor.w",   FMT_AMO},
+  {0xf800707f, 0x6000202f, "amoand.w",   FMT_AMO},
+  {0xf800707f, 0x4000202f, "amoor.w",    FMT_AMO},
+  {0xf800707f, 0x8000202f, "amomin.w",   FMT_AMO},
+  {0xf800707f, 0xa000202f, "amomax.w",   FMT_AMO},
+  {0xf800707f, 0xc000202f, "amominu.w",  FMT_AMO},
+  {0xf800707f, 0xe000202f, "amomaxu.w",  FMT_AMO},
+  {0xf9f0707f, 0x1000302f, "lr.d",       FMT_LR},
+  {0xf800707f, 0x1800302f, "sc.d",       FMT_AMO},
+  {0xf800707f, 0x0800302f, "amoswap.d",  FMT_AMO},
+  {0xf800707f, 0x0000302f, "amoadd.d",   FMT_AMO},
+  {0xf800707f, 0x2000302f, "amoxor.d",   FMT_AMO},
+  {0xf800707f, 0x6000302f, "amoand.d",   FMT_AMO},
+  {0xf800707f, 0x4000302f, "amoor.d",    FMT_AMO},
+  {0xf800707f, 0x8000302f, "amomin.d",   FMT_AMO},
+  {0xf800707f, 0xa000302f, "amomax.d",   FMT_AMO},
+  {0xf800707f, 0xc000302f, "amominu.d",  FMT_AMO},
+  {0xf800707f, 0xe000302f, "amomaxu.d",  FMT_AMO},
+
+  // RV64F
+  {0x0000707f, 0x00002007, "flw",        FMT_FLOAD},
+  {0x0000707f, 0x00002027, "fsw",        FMT_FSTORE},
+  {0x0600007f, 0x00000043, "fmadd.s",    FMT_FR4},
+  {0x0600007f, 0x00000047, "fmsub.s",    FMT_FR4},
+  {0x0600007f, 0x0000004b, "fnmsub.s",   FMT_FR4},
+  {0x0600007f, 0x0000004f, "fnmadd.s",   FMT_FR4},
+  {0xfe00007f, 0x00000053, "fadd.s",     FMT_FR},
+  {0xfe00007f, 0x08000053, "fsub.s",     FMT_FR},
+  {0xfe00007f, 0x10000053, "fmul.s",     FMT_FR},
+  {0xfe00007f, 0x18000053, "fdiv.s",     FMT_FR},
+  {0xfff0007f, 0x58000053, "fsqrt.s",    FMT_FR1},
+  {0xfe00707f, 0x20000053, "fsgnj.s",    FMT_FR},
+  {0xfe00707f, 0x20001053, "fsgnjn.s",   FMT_FR},
+  {0xfe00707f, 0x20002053, "fsgnjx.s",   FMT_FR},
+  {0xfe00707f, 0x28000053, "fmin.s",     FMT_FR},
+  {0xfe00707f, 0x28001053, "fmax.s",     FMT_FR},
+  {0xfe00707f, 0xa0000053, "fle.s",      FMT_FCMP},
+  {0xfe00707f, 0xa0001053, "flt.s",      FMT_FCMP},
+  {0xfe00707f, 0xa0002053, "feq.s",      FMT_FCMP},
+  {0xfff0007f, 0xc0000053, "fcvt.w.s",   FMT_F2X},
+  {0xfff0007f, 0xc0100053, "fcvt.wu.s",  FMT_F2X},
+  {0xfff0007f, 0xc0200053, "fcvt.l.s",   FMT_F2X},
+  {0xfff0007f, 0xc0300053, "fcvt.lu.s",  FMT_F2X},
+  {0xfff0007f, 0xd0000053, "fcvt.s.w",   FMT_X2F},
+  {0xfff0007f, 0xd0100053, "fcvt.s.wu",  FMT_X2F},
+  {0xfff0007f, 0xd0200053, "fcvt.s.l",   FMT_X2F},
+  {0xfff0007f, 0xd0300053, "fcvt.s.lu",  FMT_X2F},
+  {0xfff0707f, 0xe0000053, "fmv.x.w",    FMT_F2X},
+  {0xfff0707f, 0xe0001053, "fclass.s",   FMT_F2X},
+  {0xfff0707f, 0xf0000053, "fmv.w.x",    FMT_X2F},
+
+  // RV64D
+  {0x0000707f, 0x00003007, "fld",        FMT_FLOAD},
+  {0x0000707f, 0x00003027, "fsd",        FMT_FSTORE},
+  {0x0600007f, 0x02000043, "fmadd.d",    FMT_FR4},
+  {0x0600007f, 0x02000047, "fmsub.d",    FMT_FR4},
+  {0x0600007f, 0x0200004b, "fnmsub.d",   FMT_FR4},
+  {0x0600007f, 0x0200004f, "fnmadd.d",   FMT_FR4},
+  {0xfe00007f, 0x02000053, "fadd.d",     FMT_FR},
+  {0xfe00007f, 0x0a000053, "fsub.d",     FMT_FR},
+  {0xfe00007f, 0x12000053, "fmul.d",     FMT_FR},
+  {0xfe00007f, 0x1a000053, "fdiv.d",     FMT_FR},
+  {0xfff0007f, 0x5a000053, "fsqrt.d",    FMT_FR1},
+  {0xfe00707f, 0x22000053, "fsgnj.d",    FMT_FR},
+  {0xfe00707f, 0x22001053, "fsgnjn.d",   FMT_FR},
+  {0xfe00707f, 0x22002053, "fsgnjx.d",   FMT_FR},
+  {0xfe00707f, 0x2a000053, "fmin.d",     FMT_FR},
+  {0xfe00707f, 0x2a001053, "fmax.d",     FMT_FR},
+  {0xfff0007f, 0x40100053, "fcvt.s.d",   FMT_FR1},
+  {0xfff0007f, 0x42000053, "fcvt.d.s",   FMT_FR1},
+  {0xfe00707f, 0xa2000053, "fle.d",      FMT_FCMP},
+  {0xfe00707f, 0xa2001053, "flt.d",      FMT_FCMP},
+  {0xfe00707f, 0xa2002053, "feq.d",      FMT_FCMP},
+  {0xfff0007f, 0xc2000053, "fcvt.w.d",   FMT_F2X},
+  {0xfff0007f, 0xc2100053, "fcvt.wu.d",  FMT_F2X},
+  {0xfff0007f, 0xc2200053, "fcvt.l.d",   FMT_F2X},
+  {0xfff0007f, 0xc2300053, "fcvt.lu.d",  FMT_F2X},
+  {0xfff0007f, 0xd2000053, "fcvt.d.w",   FMT_X2F},
+  {0xfff0007f, 0xd2100053, "fcvt.d.wu",  FMT_X2F},
+  {0xfff0007f, 0xd2200053, "fcvt.d.l",   FMT_X2F},
+  {0xfff0007f, 0xd2300053, "fcvt.d.lu",  FMT_X2F},
+  {0xfff0707f, 0xe2000053, "fmv.x.d",    FMT_F2X},
+  {0xfff0707f, 0xe2001053, "fclass.d",   FMT_F2X},
+  {0xfff0707f, 0xf2000053, "fmv.d.x",    FMT_X2F},
+};
+
+// Opcode table entries grouped by the major opcode (bits 6:2), so only a few
+// need to be checked for each instruction.
+typedef std::array<vector<const opcode_t*>, 32> opcode_index_t;
+
+static opcode_index_t build_index() {
+  opcode_index_t index;
+  for (const opcode_t& opcode : opcodes)
+    index[(opcode.match >> 2) & 31].push_back(&opcode);
+  return index;
+}
+
+static const opcode_index_t& opcode_index() {
+  static const opcode_index_t index = build_index();
+  return index;
+}
+
+// Extract bits [hi:lo] of `value`.
+static uint32_t bits(uint32_t value, int hi, int lo) {
+  return (value >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+// Sign-extend the lowest `width` bits of `value`.
+static int32_t sign_extend(uint32_t value, int width) {
+  return (int32_t)(value << (32 - width)) >> (32 - width);
+}
+
+static string hex(uint32_t value) {
+  std::stringstream ss;
+  ss << "0x" << std::hex << value;
+  return ss.str();
+}
+
+static string pc_relative(int32_t offset) {
+  return (offset < 0) ? "pc - " + to_string(-offset)
+                      : "pc + " + to_string(offset);
+}
+
+static string address(int32_t offset, int base) {
+  return to_string(offset) + "(" + gpr_name(base) + ")";
+}
+
+static string fence_set(uint32_t set) {
+  string result;
+  if (set & 8) result += "i";
+  if (set & 4) result += "o";
+  if (set & 2) result += "r";
+  if (set & 1) result += "w";
+  return result.empty() ? "0" : result;
+}
+
+static disassembly_t disassemble_32(uint32_t instr) {
+  const opcode_t* opcode = NULL;
+  for (const opcode_t* candidate : opcode_index()[bits(instr, 6, 2)]) {
+    if ((instr & candidate->mask) == candidate->match) {
+      opcode = candidate;
+      break;
+    }
+  }
+
+  if (opcode == NULL)
+    return {"unknown", ""};
+
+  int rd = bits(instr, 11, 7);
+  int rs1 = bits(instr, 19, 15);
+  int rs2 = bits(instr, 24, 20);
+  int rs3 = bits(instr, 31, 27);
+
+  int32_t imm_i = sign_extend(bits(instr, 31, 20), 12);
+  int32_t imm_s = sign_extend((bits(instr, 31, 25) << 5) | bits(instr, 11, 7), 12);
+  int32_t imm_b = sign_extend((bits(instr, 31, 31) << 12) | (bits(instr, 7, 7) << 11) |
+                              (bits(instr, 30, 25) << 5) | (bits(instr, 11, 8) << 1), 13);
+  int32_t imm_j = sign_extend((bits(instr, 31, 31) << 20) | (bits(instr, 19, 12) << 12) |
+                              (bits(instr, 20, 20) << 11) | (bits(instr, 30, 21) << 1), 21);
+
+  disassembly_t result = {opcode->name, ""};
+  string& ops = result.operands;
+
+  switch (opcode->format) {
+    case FMT_NONE:
+      break;
+    case FMT_R:
+      ops = string(gpr_name(rd)) + ", " + gpr_name(rs1) + ", " + gpr_name(rs2);
+      break;
+    case FMT_I:
+      ops = string(gpr_name(rd)) + ", " + gpr_name(rs1) + ", " + to_string(imm_i);
+      break;
+    case FMT_SHIFT:
+      ops = string(gpr_name(rd)) + ", " + gpr_name(rs1) + ", " + to_string(bits(instr, 25, 20));
+      break;
+    case FMT_LOAD:
+      ops = string(gpr_name(rd)) + ", " + address(imm_i, rs1);
+      break;
+    case FMT_STORE:
+      ops = string(gpr_name(rs2)) + ", " + address(imm_s, rs1);
+      break;
+    case FMT_BRANCH:
+      ops = string(gpr_name(rs1)) + ", " + gpr_name(rs2) + ", " + pc_relative(imm_b);
+      break;
+    case FMT_U:
+      ops = string(gpr_name(rd)) + ", " + hex(bits(instr, 31, 12));
+      break;
+    case FMT_JAL:
+      ops = string(gpr_name(rd)) + ", " + pc_relative(imm_j);
+      break;
+    case FMT_CSR:
+      ops = string(gpr_name(rd)) + ", " + csr_name(bits(instr, 31, 20)) + ", " + gpr_name(rs1);
+      break;
+    case FMT_CSRI:
+      ops = string(gpr_name(rd)) + ", " + csr_name(bits(instr, 31, 20)) + ", " + to_string(rs1);
+      break;
+    case FMT_FENCE:
+      ops = fence_set(bits(instr, 27, 24)) + ", " + fence_set(bits(instr, 23, 20));
+      break;
+    case FMT_AMO:
+      ops = string(gpr_name(rd)) + ", " + gpr_name(rs2) + ", (" + gpr_name(rs1) + ")";
+      break;
+    case FMT_LR:
+      ops = string(gpr_name(rd)) + ", (" + gpr_name(rs1) + ")";
+      break;
+    case FMT_SFENCE:
+      ops = string(gpr_name(rs1)) + ", " + gpr_name(rs2);
+      break;
+    case FMT_FLOAD:
+      ops = string(fpr_name(rd)) + ", " + address(imm_i, rs1);
+      break;
+    case FMT_FSTORE:
+      ops = string(fpr_name(rs2)) + ", " + address(imm_s, rs1);
+      break;
+    case FMT_FR:
+      ops = string(fpr_name(rd)) + ", " + fpr_name(rs1) + ", " + fpr_name(rs2);
+      break;
+    case FMT_FR1:
+      ops = string(fpr_name(rd)) + ", " + fpr_name(rs1);
+      break;
+    case FMT_FR4:
+      ops = string(fpr_name(rd)) + ", " + fpr_name(rs1) + ", " + fpr_name(rs2) + ", " + fpr_name(rs3);
+      break;
+    case FMT_FCMP:
+      ops = string(gpr_name(rd)) + ", " + fpr_name(rs1) + ", " + fpr_name(rs2);
+      break;
+    case FMT_F2X:
+      ops = string(gpr_name(rd)) + ", " + fpr_name(rs1);
+      break;
+    case FMT_X2F:
+      ops = string(fpr_name(rd)) + ", " + gpr_name(rs1);
+      break;
+  }
+
+  // Memory ordering bits of atomics.
+  if (opcode->format == FMT_AMO || opcode->format == FMT_LR) {
+    if (bits(instr, 26, 25) == 3)  result.name += ".aqrl";
+    else if (bits(instr, 26, 26))  result.name += ".aq";
+    else if (bits(instr, 25, 25))  result.name += ".rl";
+  }
+
+  return result;
+}
+
+// Compressed instructions have too many immediate layouts for a table to
+// help, so are decoded directly.
+static disassembly_t disassemble_16(uint32_t instr) {
+  // Full register specifiers, and the 3-bit ones for x8-x15.
+  int rd = bits(instr, 11, 7);
+  int rs2 = bits(instr, 6, 2);
+  int rd_c = 8 + bits(instr, 4, 2);
+  int rs1_c = 8 + bits(instr, 9, 7);
+
+  int32_t imm6 = sign_extend((bits(instr, 12, 12) << 5) | bits(instr, 6, 2), 6);
+  uint32_t shamt = (bits(instr, 12, 12) << 5) | bits(instr, 6, 2);
+
+  // Offsets of loads and stores, scaled by access size.
+  uint32_t offset_w = (bits(instr, 12, 10) << 3) | (bits(instr, 6, 6) << 2) |
+                      (bits(instr, 5, 5) << 6);
+  uint32_t offset_d = (bits(instr, 12, 10) << 3) | (bits(instr, 6, 5) << 6);
+  uint32_t offset_lwsp = (bits(instr, 12, 12) << 5) | (bits(instr, 6, 4) << 2) |
+                         (bits(instr, 3, 2) << 6);
+  uint32_t offset_ldsp = (bits(instr, 12, 12) << 5) | (bits(instr, 6, 5) << 3) |
+                         (bits(instr, 4, 2) << 6);
+  uint32_t offset_swsp = (bits(instr, 12, 9) << 2) | (bits(instr, 8, 7) << 6);
+  uint32_t offset_sdsp = (bits(instr, 12, 10) << 3) | (bits(instr, 9, 7) << 6);
+
+  int32_t offset_j = sign_extend((bits(instr, 12, 12) << 11) | (bits(instr, 11, 11) << 4) |
+                                 (bits(instr, 10, 9) << 8) | (bits(instr, 8, 8) << 10) |
+                                 (bits(instr, 7, 7) << 6) | (bits(instr, 6, 6) << 7) |
+                                 (bits(instr, 5, 3) << 1) | (bits(instr, 2, 2) << 5), 12);
+  int32_t offset_b = sign_extend((bits(instr, 12, 12) << 8) | (bits(instr, 11, 10) << 3) |
+                                 (bits(instr, 6, 5) << 6) | (bits(instr, 4, 3) << 1) |
+                                 (bits(instr, 2, 2) << 5), 9);
+
+  // Cases are written in octal: quadrant, then funct3.
+  switch ((bits(instr, 1, 0) << 3) | bits(instr, 15, 13)) {
+    // Quadrant 0
+    case 000: {
+      uint32_t imm = (bits(instr, 12, 11) << 4) | (bits(instr, 10, 7) << 6) |
+                     (bits(instr, 6, 6) << 2) | (bits(instr, 5, 5) << 3);
+      if (imm == 0)
+        break;
+      return {"c.addi4spn", string(gpr_name(rd_c)) + ", sp, " + to_string(imm)};
+    }
+    case 001: return {"c.fld", string(fpr_name(rd_c)) + ", " + address(offset_d, rs1_c)};
+    case 002: return {"c.lw",  string(gpr_name(rd_c)) + ", " + address(offset_w, rs1_c)};
+    case 003: return {"c.ld",  string(gpr_name(rd_c)) + ", " + address(offset_d, rs1_c)};
+    case 005: return {"c.fsd", string(fpr_name(rd_c)) + ", " + address(offset_d, rs1_c)};
+    case 006: return {"c.sw",  string(gpr_name(rd_c)) + ", " + address(offset_w, rs1_c)};
+    case 007: return {"c.sd",  string(gpr_name(rd_c)) + ", " + address(offset_d, rs1_c)};
+
+    // Quadrant 1
+    case 010:
+      if (rd == 0)
+        return {"c.nop", ""};
+      return {"c.addi", string(gpr_name(rd)) + ", " + to_string(imm6)};
+    case 011:
+      if (rd == 0)
+        break;
+      return {"c.addiw", string(gpr_name(rd)) + ", " + to_string(imm6)};
+    case 012: return {"c.li", string(gpr_name(rd)) + ", " + to_string(imm6)};
+    case 013:
+      if (rd == 2) {
+        int32_t imm = sign_extend((bits(instr, 12, 12) << 9) | (bits(instr, 6, 6) << 4) |
+                                  (bits(instr, 5, 5) << 6) | (bits(instr, 4, 3) << 7) |
+                                  (bits(instr, 2, 2) << 5), 10);
+        if (imm == 0)
+          break;
+        return {"c.addi16sp", "sp, " + to_string(imm)};
+      }
+      if (imm6 == 0)
+        break;
+      return {"c.lui", string(gpr_name(rd)) + ", " + hex(imm6 & 0xfffff)};
+    case 014:
+      switch (bits(instr, 11, 10)) {
+        case 0: return {"c.srli", string(gpr_name(rs1_c)) + ", " + to_string(shamt)};
+        case 1: return {"c.srai", string(gpr_name(rs1_c)) + ", " + to_string(shamt)};
+        case 2: return {"c.andi", string(gpr_name(rs1_c)) + ", " + to_string(imm6)};
+        default: {
+          static const char* names[8] = {"c.sub", "c.xor", "c.or", "c.and",
+                                         "c.subw", "c.addw", NULL, NULL};
+          const char* name = names[(bits(instr, 12, 12) << 2) | bits(instr, 6, 5)];
+          if (name == NULL)
+            break;
+          return {name, string(gpr_name(rs1_c)) + ", " + gpr_name(rd_c)};
+        }
+      }
+      break;
+    case 015: return {"c.j", pc_relative(offset_j)};
+    case 016: return {"c.beqz", string(gpr_name(rs1_c)) + ", " + pc_relative(offset_b)};
+    case 017: return {"c.bnez", string(gpr_name(rs1_c)) + ", " + pc_relative(offset_b)};
+
+    // Quadrant 2
+    case 020: return {"c.slli", string(gpr_name(rd)) + ", " + to_string(shamt)};
+    case 021: return {"c.fldsp", string(fpr_name(rd)) + ", " + address(offset_ldsp, 2)};
+    case 022:
+      if (rd == 0)
+        break;
+      return {"c.lwsp", string(gpr_name(rd)) + ", " + address(offset_lwsp, 2)};
+    case 023:
+      if (rd == 0)
+        break;
+      return {"c.ldsp", string(gpr_name(rd)) + ", " + address(offset_ldsp, 2)};
+    case 024:
+      if (bits(instr, 12, 12) == 0) {
+        if (rs2 == 0)
+          return (rd == 0) ? disassembly_t{"unknown", ""}
+                           : disassembly_t{"c.jr", gpr_name(rd)};
+        return {"c.mv", string(gpr_name(rd)) + ", " + gpr_name(rs2)};
+      }
+      if (rd == 0 && rs2 == 0)
+        return {"c.ebreak", ""};
+      if (rs2 == 0)
+        return {"c.jalr", gpr_name(rd)};
+      return {"c.add", string(gpr_name(rd)) + ", " + gpr_name(rs2)};
+    case 025: return {"c.fsdsp", string(fpr_name(rs2)) + ", " + address(offset_sdsp, 2)};
+    case 026: return {"c.swsp",  string(gpr_name(rs2)) + ", " + address(offset_swsp, 2)};
+    case 027: return {"c.sdsp",  string(gpr_name(rs2)) + ", " + address(offset_sdsp, 2)};
+
+    default:
+      break;
+  }
+
+  return {"unknown", ""};
+}
+
+disassembly_t disassemble(uint32_t instr_word) {
+  if (bits(instr_word, 1, 0) == 3)
+    return disassemble_32(instr_word);
+  else
+    return disassemble_16(instr_word & 0xffff);
+}
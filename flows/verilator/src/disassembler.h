@@ -0,0 +1,29 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Decode RV64GC instruction words into assembly text, for traces.
+
+#ifndef DISASSEMBLER_H
+#define DISASSEMBLER_H
+
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+typedef struct {
+  // Mnemonic, e.g. "addi", or "unknown" if the instruction couldn't be
+  // decoded.
+  string name;
+
+  // Comma-separated operands, e.g. "a0, a0, 1". Branch and jump targets are
+  // shown relative to the instruction, e.g. "pc + 8".
+  string operands;
+} disassembly_t;
+
+// Decode one instruction. Compressed instructions occupy the lower 16 bits of
+// `instr_word`; the upper bits are ignored.
+disassembly_t disassemble(uint32_t instr_word);
+
+#endif  // DISASSEMBLER_H
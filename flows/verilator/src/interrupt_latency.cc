@@ -0,0 +1,110 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <iomanip>
+
+#include "interrupt_latency.h"
+
+using std::setw;
+
+static const char* interrupt_name(int cause) {
+  switch (cause) {
+    case 1:  return "supervisor software";
+    case 3:  return "machine software";
+    case 5:  return "supervisor timer";
+    case 7:  return "machine timer";
+    case 9:  return "supervisor external";
+    case 11: return "machine external";
+    default: return "unknown";
+  }
+}
+
+InterruptLatency::InterruptLatency() {
+  clear();
+}
+
+void InterruptLatency::clear() {
+  previous_pending = 0;
+  awaiting_handler = false;
+  entry_latency.clear();
+  trap_latency.clear();
+}
+
+void InterruptLatency::record(latency_stats_t& stats, uint64_t latency) {
+  if (stats.count == 0) {
+    stats.min = latency;
+    stats.max = latency;
+  }
+  else {
+    stats.min = std::min(stats.min, latency);
+    stats.max = std::max(stats.max, latency);
+  }
+
+  stats.count++;
+  stats.total += latency;
+
+  size_t bucket = 0;
+  while ((2ULL << bucket) <= latency)
+    bucket++;
+
+  if (stats.histogram.size() <= bucket)
+    stats.histogram.resize(bucket + 1, 0);
+  stats.histogram[bucket]++;
+}
+
+void InterruptLatency::update(uint64_t cycle, uint32_t pending,
+                              const trap_trace_t& trap, MemoryAddress pc) {
+  uint32_t rising = pending & ~previous_pending;
+  previous_pending = pending;
+
+  for (int cause=0; cause<16; cause++)
+    if (rising & (1 << cause))
+      asserted[cause] = cycle;
+
+  // The handler's first instruction has reached the end of the pipeline.
+  if (awaiting_handler && pc == handler_address) {
+    record(entry_latency[handler_cause], cycle - handler_asserted);
+    awaiting_handler = false;
+  }
+
+  // Only interrupts whose request was seen can be measured.
+  bool interrupt = trap.cause & 0x10;
+  int cause = trap.cause & 0xf;
+  if (trap.valid && interrupt && (previous_pending & (1 << cause))) {
+    awaiting_handler = true;
+    handler_cause = cause;
+    handler_asserted = asserted[cause];
+    handler_trap = cycle;
+    handler_address = trap.tvec;
+    record(trap_latency[cause], cycle - asserted[cause]);
+  }
+}
+
+void InterruptLatency::print_report(std::ostream& os) const {
+  if (entry_latency.empty()) {
+    os << "Interrupt latency: no interrupts handled\n";
+    return;
+  }
+
+  for (auto& entry : entry_latency) {
+    const latency_stats_t& stats = entry.second;
+    const latency_stats_t& trap = trap_latency.at(entry.first);
+
+    os << "Interrupt latency (" << interrupt_name(entry.first) << "): "
+       << stats.count << " interrupts, request to handler entry min "
+       << stats.min << ", mean " << (stats.total / stats.count) << ", max "
+       << stats.max << " cycles; request to trap mean "
+       << (trap.total / trap.count) << " cycles\n";
+
+    for (size_t i=0; i<stats.histogram.size(); i++) {
+      if (stats.histogram[i] == 0)
+        continue;
+
+      os << "  " << setw(8) << (i == 0 ? 0 : 1ULL << i) << " - " << std::left << setw(8)
+         << ((2ULL << i) - 1) << std::right << setw(10)
+         << stats.histogram[i] << "\n";
+    }
+  }
+}
@@ -0,0 +1,87 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Measure the time between an interrupt being requested and the core
+// executing the first instruction of its handler.
+
+#ifndef INTERRUPT_LATENCY_H
+#define INTERRUPT_LATENCY_H
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "types.h"
+
+using std::map;
+using std::vector;
+
+// Information about traps, from the core's debug outputs.
+typedef struct {
+  // A trap was taken this cycle.
+  bool          valid;
+  // As in `mcause`, but with the interrupt flag in bit 4.
+  uint8_t       cause;
+  // Address of the trap handler.
+  MemoryAddress tvec;
+} trap_trace_t;
+
+class InterruptLatency {
+public:
+
+  InterruptLatency();
+
+  void clear();
+
+  // Called once per clock cycle. `pending` holds the interrupt lines driven
+  // into the core, in the layout of `mip`. `pc` is the core's debug PC.
+  void sample(uint64_t cycle, uint32_t pending, const trap_trace_t& trap,
+              MemoryAddress pc) {
+    // Fast path: nothing changed and nothing in progress.
+    if (pending == previous_pending && !trap.valid && !awaiting_handler)
+      return;
+
+    update(cycle, pending, trap, pc);
+  }
+
+  // Print a latency histogram for each interrupt cause seen.
+  void print_report(std::ostream& os) const;
+
+private:
+
+  void update(uint64_t cycle, uint32_t pending, const trap_trace_t& trap,
+              MemoryAddress pc);
+
+  typedef struct {
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+
+    // Element i counts latencies in [2^i, 2^(i+1)).
+    vector<uint64_t> histogram;
+  } latency_stats_t;
+
+  void record(latency_stats_t& stats, uint64_t latency);
+
+  uint32_t previous_pending;
+
+  // Cycle when each interrupt line was asserted, indexed by cause.
+  uint64_t asserted[16];
+
+  // A trap has been taken for an interrupt, but its handler hasn't started.
+  bool awaiting_handler;
+  uint8_t handler_cause;
+  uint64_t handler_asserted;
+  uint64_t handler_trap;
+  MemoryAddress handler_address;
+
+  // Request to handler entry, and request to trap, indexed by cause.
+  map<int, latency_stats_t> entry_latency;
+  map<int, latency_stats_t> trap_latency;
+
+};
+
+#endif  // INTERRUPT_LATENCY_H
@@ -0,0 +1,71 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdio>
+#include <sstream>
+
+#include "logs.h"
+
+using std::string;
+using std::stringstream;
+
+// Stream buffer which passes all output straight to stdout, but ignores
+// requests to flush. This makes `endl` as cheap as "\n".
+class LogBuffer : public std::streambuf {
+protected:
+
+  virtual int overflow(int c) {
+    if (c != EOF)
+      putchar(c);
+    return c;
+  }
+
+  virtual std::streamsize xsputn(const char* s, std::streamsize n) {
+    return fwrite(s, 1, n, stdout);
+  }
+
+  virtual int sync() {
+    return 0;
+  }
+
+};
+
+static LogBuffer log_buffer;
+std::ostream log_stream(&log_buffer);
+
+uint32_t log_categories = ~0u;
+
+void log_flush() {
+  fflush(stdout);
+}
+
+void log_buffer_output() {
+  // Must be called before anything is written to stdout.
+  setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+}
+
+void set_log_categories(string names) {
+  log_categories = 0;
+
+  stringstream ss(names);
+  string name;
+
+  while (std::getline(ss, name, ',')) {
+    if (name == "sim")
+      log_categories |= 1u << LOG_SIM;
+    else if (name == "memory")
+      log_categories |= 1u << LOG_MEMORY;
+    else if (name == "ports")
+      log_categories |= 1u << LOG_PORTS;
+    else if (name == "ptw")
+      log_categories |= 1u << LOG_PTW;
+    else if (name == "tilelink")
+      log_categories |= 1u << LOG_TILELINK;
+    else {
+      MUNTJAC_ERROR << "Unknown log category: " << name << endl;
+      MUNTJAC_ERROR << "Options are: sim, memory, ports, ptw, tilelink" << endl;
+      exit(1);
+    }
+  }
+}
@@ -5,7 +5,9 @@
 #ifndef LOGS_H
 #define LOGS_H
 
+#include <cstdint>
 #include <iostream>
+#include <string>
 
 using std::cout;
 using std::cerr;
@@ -13,13 +15,60 @@ using std::endl;
 
 extern double sc_time_stamp();
 
+// Messages more detailed than this are removed at compile time, so cost
+// nothing even when logging is disabled. Pass e.g. `-CFLAGS
+// -DMUNTJAC_MAX_LOG_LEVEL=0` in the *_tb.core files for the fastest simulator.
+#ifndef MUNTJAC_MAX_LOG_LEVEL
+  #define MUNTJAC_MAX_LOG_LEVEL 2
+#endif
+
 // 0 = no logging
-// 1 = all logging
-// Potential to add more options here.
+// 1 = basic logging
+// 2 = detailed logging
 extern int log_level;
-#define MUNTJAC_LOG(LEVEL) if (log_level >= LEVEL) cout << "[sim " << std::dec << (uint64_t)sc_time_stamp() << "] "
 
-#define MUNTJAC_WARN cerr << "[sim] Warning: "
-#define MUNTJAC_ERROR cerr << "[sim] Error: "
+// Subsystems which can have their logging enabled/disabled independently.
+typedef enum {
+  LOG_SIM      = 0,  // General simulation progress
+  LOG_MEMORY   = 1,  // Main memory
+  LOG_PORTS    = 2,  // Requests and responses on memory ports
+  LOG_PTW      = 3,  // Page table walks
+  LOG_TILELINK = 4,  // TileLink channels
+} log_category_e;
+
+// Bitmask of enabled categories, indexed by `log_category_e`. All categories
+// are enabled by default.
+extern uint32_t log_categories;
+
+// Parse a comma-separated list of category names (e.g. "memory,ptw") and
+// enable only those categories. Exits with an error if a name is unknown.
+void set_log_categories(std::string names);
+
+// Output stream for log messages. Output shares stdout's buffer, so remains
+// ordered with anything the simulated program prints, but `endl` does not
+// force a flush. Use `log_flush()` when output must be visible immediately.
+extern std::ostream log_stream;
+
+// Flush all pending log messages.
+void log_flush();
+
+// Make stdout fully buffered. Called when logging is enabled, to avoid a
+// system call for every line written.
+void log_buffer_output();
+
+#define MUNTJAC_LOG_ENABLED(LEVEL, CATEGORY) \
+  ((LEVEL) <= MUNTJAC_MAX_LOG_LEVEL && (LEVEL) <= log_level && \
+   (log_categories & (1u << (CATEGORY))))
+
+// Messages are prefixed by the current clock cycle.
+#define MUNTJAC_LOG_CATEGORY(LEVEL, CATEGORY) \
+  if (!MUNTJAC_LOG_ENABLED(LEVEL, CATEGORY)) ; else \
+    log_stream << "[sim " << std::dec << (uint64_t)sc_time_stamp() << "] "
+
+#define MUNTJAC_LOG(LEVEL) MUNTJAC_LOG_CATEGORY(LEVEL, LOG_SIM)
+
+// Flush pending log messages first so warnings and errors appear in context.
+#define MUNTJAC_WARN (log_flush(), cerr) << "[sim] Warning: "
+#define MUNTJAC_ERROR (log_flush(), cerr) << "[sim] Error: "
 
 #endif  // LOGS_H
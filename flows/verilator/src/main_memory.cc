@@ -6,6 +6,7 @@
 #include <cstring>
 
 #include "exceptions.h"
+#include "logs.h"
 #include "main_memory.h"
 #include "virtual_addressing.h"
 
@@ -31,8 +32,23 @@ MainMemory::MainMemory() {
 }
 
 MainMemory::~MainMemory() {
+  clear();
+}
+
+void MainMemory::clear() {
   for (auto it=pages.begin(); it != pages.end(); ++it)
     delete[] it->second;
+
+  pages.clear();
+}
+
+void MainMemory::add_device(MemoryMappedDevice& device) {
+  devices.push_back(&device);
+}
+
+void MainMemory::reset_devices() {
+  for (MemoryMappedDevice* device : devices)
+    device->reset();
 }
 
 void MainMemory::check_access(MemoryAddress address) {
@@ -75,24 +91,32 @@ DataBlock MainMemory::read(MemoryAddress address, size_t num_bytes) {
 }
 
 void MainMemory::write(DataBlock data) {
-  check_access(data.get_address() + data.get_num_bytes() - 1);
+  write(data.get_address(), data.get_data().get(), data.get_num_bytes());
+}
+
+void MainMemory::write(MemoryAddress address, const char* data,
+                       size_t num_bytes) {
+  check_access(address + num_bytes - 1);
 
   size_t bytes_copied = 0;
-  while (bytes_copied < data.get_num_bytes()) {
-    char* page = get_page(data.get_address() + bytes_copied);
-    MemoryAddress offset = get_offset(data.get_address() + bytes_copied);
+  while (bytes_copied < num_bytes) {
+    char* page = get_page(address + bytes_copied);
+    MemoryAddress offset = get_offset(address + bytes_copied);
 
-    size_t bytes_to_copy = data.get_num_bytes() - bytes_copied;
+    size_t bytes_to_copy = num_bytes - bytes_copied;
     if (offset + bytes_to_copy > PAGE_SIZE)
       bytes_to_copy = PAGE_SIZE - offset;
 
-    memcpy(page + offset, data.get_data().get() + bytes_copied, bytes_to_copy);
+    memcpy(page + offset, data + bytes_copied, bytes_to_copy);
 
     bytes_copied += bytes_to_copy;
   }
 }
 
 uint8_t MainMemory::read8(MemoryAddress address) {
+  if (MemoryMappedDevice* device = get_device(address))
+    return device->read(address - device->get_base_address(), 1);
+
   check_access(address + sizeof(uint8_t) - 1);
 
   char* page = get_page(address);
@@ -101,6 +125,9 @@ uint8_t MainMemory::read8(MemoryAddress address) {
 }
 
 uint16_t MainMemory::read16(MemoryAddress address) {
+  if (MemoryMappedDevice* device = get_device(address))
+    return device->read(address - device->get_base_address(), 2);
+
   check_access(address + sizeof(uint16_t) - 1);
 
   char* page = get_page(address);
@@ -123,6 +150,9 @@ uint16_t MainMemory::read16(MemoryAddress address) {
 }
 
 uint32_t MainMemory::read32(MemoryAddress address) {
+  if (MemoryMappedDevice* device = get_device(address))
+    return device->read(address - device->get_base_address(), 4);
+
   check_access(address + sizeof(uint32_t) - 1);
 
   char* page = get_page(address);
@@ -145,6 +175,9 @@ uint32_t MainMemory::read32(MemoryAddress address) {
 }
 
 uint64_t MainMemory::read64(MemoryAddress address) {
+  if (MemoryMappedDevice* device = get_device(address))
+    return device->read(address - device->get_base_address(), 8);
+
   check_access(address + sizeof(uint64_t) - 1);
 
   char* page = get_page(address);
@@ -172,6 +205,11 @@ void MainMemory::write8(MemoryAddress address, uint8_t data) {
     return;
   }
 
+  if (MemoryMappedDevice* device = get_device(address)) {
+    device->write(address - device->get_base_address(), data, 1);
+    return;
+  }
+
   check_access(address + sizeof(uint8_t) - 1);
 
   char* page = get_page(address);
@@ -185,6 +223,11 @@ void MainMemory::write16(MemoryAddress address, uint16_t data) {
     return;
   }
 
+  if (MemoryMappedDevice* device = get_device(address)) {
+    device->write(address - device->get_base_address(), data, 2);
+    return;
+  }
+
   check_access(address + sizeof(uint16_t) - 1);
 
   char* page = get_page(address);
@@ -210,6 +253,11 @@ void MainMemory::write32(MemoryAddress address, uint32_t data) {
     return;
   }
 
+  if (MemoryMappedDevice* device = get_device(address)) {
+    device->write(address - device->get_base_address(), data, 4);
+    return;
+  }
+
   check_access(address + sizeof(uint32_t) - 1);
 
   char* page = get_page(address);
@@ -235,6 +283,11 @@ void MainMemory::write64(MemoryAddress address, uint64_t data) {
     return;
   }
 
+  if (MemoryMappedDevice* device = get_device(address)) {
+    device->write(address - device->get_base_address(), data, 8);
+    return;
+  }
+
   check_access(address + sizeof(uint64_t) - 1);
 
   char* page = get_page(address);
@@ -267,6 +320,9 @@ char* MainMemory::allocate_new_page(MemoryAddress address) {
   MemoryAddress tag = get_tag(address);
   assert(pages.find(tag) == pages.end());
 
+  MUNTJAC_LOG_CATEGORY(2, LOG_MEMORY) << "Allocating page at 0x" << std::hex
+      << tag << std::dec << endl;
+
   char* page = new char[PAGE_SIZE];
   pages[tag] = page;
 
@@ -10,7 +10,9 @@
 #define MAIN_MEMORY_H
 
 #include <map>
+#include <vector>
 #include "data_block.h"
+#include "memory_mapped_device.h"
 #include "types.h"
 
 class MainMemory {
@@ -30,6 +32,20 @@ public:
   // Write a block of data into memory.
   void write(DataBlock data);
 
+  // Copy `num_bytes` bytes from `data` into memory, starting at `address`.
+  // Unlike the single-value writes below, this never triggers a system call.
+  void write(MemoryAddress address, const char* data, size_t num_bytes);
+
+  // Send single-value reads and writes within the device's address range to
+  // the device instead of memory.
+  void add_device(MemoryMappedDevice& device);
+
+  // Discard all contents so a new program can be loaded. Devices are kept.
+  void clear();
+
+  // Return all devices to their initial states.
+  void reset_devices();
+
   // Read data. All values are unsigned.
   uint8_t  read8(MemoryAddress address);
   uint16_t read16(MemoryAddress address);
@@ -51,6 +67,16 @@ private:
 
   std::map<MemoryAddress, char*> pages;
 
+  // The device responsible for `address`, or NULL if it is ordinary memory.
+  MemoryMappedDevice* get_device(MemoryAddress address) const {
+    for (MemoryMappedDevice* device : devices)
+      if (device->contains(address))
+        return device;
+    return NULL;
+  }
+
+  std::vector<MemoryMappedDevice*> devices;
+
 };
 
 #endif  // MAIN_MEMORY_H
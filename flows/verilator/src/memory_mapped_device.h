@@ -0,0 +1,50 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// A device which responds to memory accesses within a range of addresses.
+
+#ifndef MEMORY_MAPPED_DEVICE_H
+#define MEMORY_MAPPED_DEVICE_H
+
+#include <cstdint>
+#include "types.h"
+
+class MemoryMappedDevice {
+public:
+
+  MemoryMappedDevice(MemoryAddress base, uint64_t size) :
+      base(base),
+      size(size) {
+    // Nothing.
+  }
+
+  virtual ~MemoryMappedDevice() {}
+
+  void set_base_address(MemoryAddress base) {
+    this->base = base;
+  }
+
+  MemoryAddress get_base_address() const {
+    return base;
+  }
+
+  bool contains(MemoryAddress address) const {
+    return (address - base) < size;
+  }
+
+  // Accesses of `num_bytes` bytes. `offset` is relative to the base address.
+  virtual uint64_t read(MemoryAddress offset, int num_bytes) = 0;
+  virtual void write(MemoryAddress offset, uint64_t data, int num_bytes) = 0;
+
+  // Return to the initial state, ready for a new program.
+  virtual void reset() {}
+
+protected:
+
+  MemoryAddress base;
+  uint64_t size;
+
+};
+
+#endif  // MEMORY_MAPPED_DEVICE_H
@@ -38,6 +38,10 @@ void MemoryPort<T>::set_outputs(uint64_t time) {
 
   // Send responses to core.
   if (!responses.empty() && responses.front().time <= time && can_send_response()) {
+    MUNTJAC_LOG_CATEGORY(2, LOG_PORTS) << "Sending response 0x" << std::hex
+        << (uint64_t)responses.front().data << std::dec << " (exception "
+        << responses.front().exception << ")" << endl;
+
     send_response(responses.front());
 
     // Remove the response from the queue when it has all been sent.
@@ -46,6 +50,11 @@ void MemoryPort<T>::set_outputs(uint64_t time) {
   }
 }
 
+template<typename T>
+void MemoryPort<T>::reset() {
+  responses = queue<response_t>();
+}
+
 template<typename T>
 void MemoryPort<T>::queue_response(T data, exc_cause_e exception) {
   response_t response;
@@ -43,6 +43,9 @@ public:
   void get_inputs(uint64_t time);
   void set_outputs(uint64_t time);
 
+  // Discard all pending responses, e.g. when the core is reset.
+  virtual void reset();
+
 protected:
 
   virtual bool can_receive_request() = 0;
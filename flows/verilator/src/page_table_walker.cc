@@ -5,6 +5,7 @@
 #include <cassert>
 
 #include "exceptions.h"
+#include "logs.h"
 #include "page_table_entry.h"
 #include "page_table_walker.h"
 #include "virtual_addressing.h"
@@ -144,6 +145,11 @@ MemoryAddress PageTableWalkerSv39::translate(
   uint ppn0 = (i > 0) ? va.virtual_page_number(0) : pte.physical_page_number(0);
   uint ppn1 = (i > 1) ? va.virtual_page_number(1) : pte.physical_page_number(1);
   uint ppn2 = (i > 2) ? va.virtual_page_number(2) : pte.physical_page_number(2);
-  return Sv39(offset, ppn0, ppn1, ppn2).get_value();
+  MemoryAddress physical_address = Sv39(offset, ppn0, ppn1, ppn2).get_value();
+
+  MUNTJAC_LOG_CATEGORY(2, LOG_PTW) << "Translated 0x" << std::hex
+      << virtual_address << " to 0x" << physical_address << std::dec << endl;
+
+  return physical_address;
 
 }
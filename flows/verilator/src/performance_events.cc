@@ -0,0 +1,44 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <iomanip>
+
+#include "performance_events.h"
+
+PerformanceEvents::PerformanceEvents() {
+  clear();
+}
+
+void PerformanceEvents::clear() {
+  for (int i=0; i<HPM_EVENT_NUM; i++)
+    counts[i] = 0;
+}
+
+void PerformanceEvents::print_cpi_stack(std::ostream& os, uint64_t cycles,
+                                        uint64_t instructions) const {
+  uint64_t mispredict = counts[HPM_EVENT_MISPREDICT_STALL];
+  uint64_t frontend = counts[HPM_EVENT_FRONTEND_STALL];
+  uint64_t backend = counts[HPM_EVENT_BACKEND_STALL];
+  uint64_t stalls = mispredict + frontend + backend;
+  uint64_t issue = (cycles > stalls) ? (cycles - stalls) : 0;
+
+  // Avoid division by zero if nothing executed.
+  double divisor = (instructions > 0) ? instructions : 1;
+
+  os << std::fixed << std::setprecision(3);
+  os << "CPI stack: " << cycles << " cycles, " << instructions
+     << " instructions, CPI " << (cycles / divisor) << "\n";
+  os << "  issue            " << (issue / divisor) << "\n";
+  os << "  frontend stall   " << (frontend / divisor)
+     << "  (" << counts[HPM_EVENT_L1_ICACHE_MISS] << " icache misses, "
+     << counts[HPM_EVENT_L1_ITLB_MISS] << " ITLB misses)\n";
+  os << "  bad speculation  " << (mispredict / divisor)
+     << "  (" << counts[HPM_EVENT_BRANCH_MISPREDICT] << " branch mispredicts)\n";
+  os << "  backend stall    " << (backend / divisor)
+     << "  (" << counts[HPM_EVENT_L1_DCACHE_MISS] << " dcache misses, "
+     << counts[HPM_EVENT_L1_DTLB_MISS] << " DTLB misses, "
+     << counts[HPM_EVENT_DIV_BUSY] << " divider busy cycles, "
+     << counts[HPM_EVENT_FPU_BUSY] << " FPU busy cycles)\n";
+  os << std::defaultfloat;
+}
@@ -0,0 +1,66 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Accumulate the hardware performance monitor events exported by the core.
+
+#ifndef PERFORMANCE_EVENTS_H
+#define PERFORMANCE_EVENTS_H
+
+#include <cstdint>
+#include <ostream>
+
+// Always ensure this matches hpm_event_e in muntjac_pkg.sv.
+typedef enum {
+  HPM_EVENT_NONE              = 0,
+  HPM_EVENT_L1_ICACHE_ACCESS  = 1,
+  HPM_EVENT_L1_ICACHE_MISS    = 2,
+  HPM_EVENT_L1_ITLB_MISS      = 3,
+  HPM_EVENT_L1_DCACHE_ACCESS  = 4,
+  HPM_EVENT_L1_DCACHE_MISS    = 5,
+  HPM_EVENT_L1_DTLB_MISS      = 6,
+  HPM_EVENT_L2_ACQ_COUNT      = 7,
+  HPM_EVENT_L2_REL_COUNT      = 8,
+  HPM_EVENT_L2_MISS           = 9,
+  HPM_EVENT_BRANCH_MISPREDICT = 10,
+  HPM_EVENT_MISPREDICT_STALL  = 11,
+  HPM_EVENT_FRONTEND_STALL    = 12,
+  HPM_EVENT_BACKEND_STALL     = 13,
+  HPM_EVENT_DIV_BUSY          = 14,
+  HPM_EVENT_FPU_BUSY          = 15,
+
+  HPM_EVENT_NUM
+} hpm_event_e;
+
+class PerformanceEvents {
+public:
+
+  PerformanceEvents();
+
+  void clear();
+
+  // Called once per clock cycle with one bit set for each active event.
+  // Defined here so it can be inlined into the simulation loop.
+  void sample(uint32_t events) {
+    // Most cycles have no events. Otherwise, visit only the bits which are set.
+    while (events != 0) {
+      int event = __builtin_ctz(events);
+      counts[event]++;
+      events &= events - 1;
+    }
+  }
+
+  uint64_t count(hpm_event_e event) const {return counts[event];}
+
+  // Print a top-down breakdown of cycles per instruction. Each cycle is
+  // attributed to instruction issue or to one type of stall.
+  void print_cpi_stack(std::ostream& os, uint64_t cycles,
+                       uint64_t instructions) const;
+
+private:
+
+  uint64_t counts[HPM_EVENT_NUM];
+
+};
+
+#endif  // PERFORMANCE_EVENTS_H
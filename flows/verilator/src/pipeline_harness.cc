@@ -31,6 +31,34 @@ protected:
   virtual void set_reset(int value) {dut.rst_ni = !value;}
   virtual MemoryAddress get_program_counter() {return dut.dbg_pc_o;}
 
+  virtual uint32_t get_performance_events() {return dut.dbg_hpm_event_o;}
+
+  virtual branch_trace_t get_branch_trace() {
+    branch_trace_t trace;
+    trace.resolved = dut.dbg_branch_resolved_o;
+    trace.type = (branch_type_e)dut.dbg_branch_type_o;
+    trace.pc = dut.dbg_branch_pc_o;
+    trace.target = dut.dbg_branch_target_o;
+    trace.mispredict = dut.dbg_branch_mispredict_o;
+    trace.predicted = dut.dbg_branch_predicted_o;
+    return trace;
+  }
+
+  virtual trap_trace_t get_trap_trace() {
+    trap_trace_t trace;
+    trace.valid = dut.dbg_trap_valid_o;
+    trace.cause = dut.dbg_trap_cause_o;
+    trace.tvec = dut.dbg_trap_tvec_o;
+    return trace;
+  }
+
+  virtual void set_interrupts(uint32_t pending) {
+    dut.irq_software_m_i = (pending >> 3) & 1;
+    dut.irq_timer_m_i = (pending >> 7) & 1;
+    dut.irq_external_s_i = (pending >> 9) & 1;
+    dut.irq_external_m_i = (pending >> 11) & 1;
+  }
+
   virtual instr_trace_t get_trace_info() {
     // The RTL must be compiled with TRACE_ENABLE to enable all of these.
     instr_trace_t trace;
@@ -66,6 +94,9 @@ protected:
     dut.irq_external_m_i = 0;
     dut.irq_external_s_i = 0; // sip[9]
     dut.hart_id_i = 0;
+
+    instruction_port.reset();
+    data_port.reset();
   }
 
   // The timing requirements are delicate. In each cycle, we have:
@@ -84,14 +115,14 @@ protected:
   // In order to achieve a single-cycle cache latency, we need:
   //   posedge eval -> get_inputs -> set_outputs -> posedge eval
   virtual void cycle_first_half() {
-    dut.eval();
+    eval();
 
     instruction_port.set_outputs(simulation_time());
     data_port.set_outputs(simulation_time());
   }
 
   virtual void cycle_second_half() {
-    dut.eval();
+    eval();
 
     instruction_port.get_inputs(simulation_time());
     data_port.get_inputs(simulation_time());
@@ -0,0 +1,291 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "logs.h"
+#include "plic.h"
+
+using std::setw;
+
+// Register offsets.
+#define PLIC_PRIORITY        0x000000  // 4 bytes per source
+#define PLIC_PENDING         0x001000
+#define PLIC_ENABLE          0x002000  // 0x80 bytes per context
+#define PLIC_CONTEXT         0x200000  // 0x1000 bytes per context
+#define PLIC_ENABLE_STRIDE   0x80
+#define PLIC_CONTEXT_STRIDE  0x1000
+#define PLIC_THRESHOLD       0x0       // Within a context
+#define PLIC_CLAIM           0x4       // Within a context
+
+#define PLIC_MAX_PRIORITY    7
+
+// Bit of `mip` driven by each context.
+static const int context_interrupt[Plic::NUM_CONTEXTS] = {11, 9};
+
+Plic::Plic() :
+    MemoryMappedDevice(DEFAULT_ADDRESS, 0x4000000) {
+  now = 0;
+  clear();
+  reset();
+}
+
+void Plic::set_stimulus(string filename) {
+  std::ifstream file(filename);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to read interrupt stimulus from " << filename << endl;
+    exit(1);
+  }
+
+  stimulus.clear();
+
+  string line;
+  int line_number = 0;
+  while (std::getline(file, line)) {
+    line_number++;
+
+    std::istringstream fields(line);
+    string kind;
+    if (!(fields >> kind) || kind[0] == '#')
+      continue;
+
+    stimulus_t event = {0, 0, 0, 1};
+    bool valid;
+
+    if (kind == "at") {
+      valid = bool(fields >> event.cycle >> event.source);
+    }
+    else if (kind == "every") {
+      valid = bool(fields >> event.period >> event.source) && event.period > 0;
+      event.cycle = event.period;
+      event.count = UINT64_MAX;
+      if (valid && (fields >> event.cycle))
+        fields >> event.count;
+    }
+    else
+      valid = false;
+
+    if (!valid || event.source <= 0 || event.source >= NUM_SOURCES) {
+      MUNTJAC_ERROR << filename << ":" << line_number
+                    << ": invalid interrupt stimulus \"" << line << "\"" << endl;
+      exit(1);
+    }
+
+    if (event.count > 0)
+      stimulus.push_back(event);
+  }
+
+  file.close();
+  reset();
+}
+
+void Plic::reset() {
+  start_cycle = now;
+
+  for (int i=0; i<NUM_SOURCES; i++) {
+    priority[i] = 0;
+    request_cycle[i] = 0;
+  }
+
+  for (int i=0; i<NUM_CONTEXTS; i++) {
+    enable[i] = 0;
+    threshold[i] = 0;
+  }
+
+  pending = 0;
+  in_flight = 0;
+
+  events = decltype(events)(later(), stimulus);
+  next_event = events.empty() ? UINT64_MAX : start_cycle + events.top().cycle;
+
+  update();
+}
+
+void Plic::clear() {
+  for (int i=0; i<NUM_SOURCES; i++)
+    stats[i] = {0, 0, 0, 0, 0};
+}
+
+void Plic::fire_events() {
+  while (!events.empty() && start_cycle + events.top().cycle <= now) {
+    stimulus_t event = events.top();
+    events.pop();
+
+    if ((pending | in_flight) & (1u << event.source))
+      stats[event.source].coalesced++;
+    else
+      request(event.source);
+
+    if (event.period > 0 && --event.count > 0) {
+      event.cycle += event.period;
+      events.push(event);
+    }
+  }
+
+  next_event = events.empty() ? UINT64_MAX : start_cycle + events.top().cycle;
+}
+
+void Plic::request(int source) {
+  pending |= 1u << source;
+  request_cycle[source] = now;
+  stats[source].requests++;
+  update();
+}
+
+int Plic::best_source(int context) const {
+  uint32_t candidates = pending & enable[context];
+  int best = 0;
+  uint32_t best_priority = threshold[context];
+
+  // Ties go to the lowest ID.
+  for (int i=1; i<NUM_SOURCES; i++) {
+    if ((candidates & (1u << i)) && priority[i] > best_priority) {
+      best = i;
+      best_priority = priority[i];
+    }
+  }
+
+  return best;
+}
+
+void Plic::update() {
+  interrupts = 0;
+
+  if (pending == 0)
+    return;
+
+  for (int i=0; i<NUM_CONTEXTS; i++)
+    if (best_source(i) != 0)
+      interrupts |= 1 << context_interrupt[i];
+}
+
+uint64_t Plic::read(MemoryAddress offset, int num_bytes) {
+  // All registers are 32 bits wide. A 64-bit access covers two registers.
+  // Claiming is a side effect, so only happens when software reads exactly
+  // the claim register.
+  if (num_bytes == 8)
+    return read_register(offset, false) |
+           ((uint64_t)read_register(offset + 4, false) << 32);
+  else {
+    bool claim = (num_bytes == 4) && (offset & 3) == 0;
+    return read_register(offset & ~3, claim) >> ((offset & 3) * 8);
+  }
+}
+
+void Plic::write(MemoryAddress offset, uint64_t data, int num_bytes) {
+  // Narrower writes are ignored.
+  if (num_bytes == 8) {
+    write_register(offset, data);
+    write_register(offset + 4, data >> 32);
+  }
+  else if (num_bytes == 4)
+    write_register(offset, data);
+}
+
+uint32_t Plic::read_register(MemoryAddress offset, bool claim) {
+  if (offset < PLIC_PENDING)
+    return (offset / 4 < NUM_SOURCES) ? priority[offset / 4] : 0;
+
+  if (offset == PLIC_PENDING)
+    return pending;
+
+  if (offset >= PLIC_ENABLE && offset < PLIC_CONTEXT) {
+    MemoryAddress context = (offset - PLIC_ENABLE) / PLIC_ENABLE_STRIDE;
+    bool first_word = ((offset - PLIC_ENABLE) % PLIC_ENABLE_STRIDE) == 0;
+    return (context < NUM_CONTEXTS && first_word) ? enable[context] : 0;
+  }
+
+  if (offset >= PLIC_CONTEXT) {
+    MemoryAddress context = (offset - PLIC_CONTEXT) / PLIC_CONTEXT_STRIDE;
+    if (context >= NUM_CONTEXTS)
+      return 0;
+
+    switch ((offset - PLIC_CONTEXT) % PLIC_CONTEXT_STRIDE) {
+      case PLIC_THRESHOLD:
+        return threshold[context];
+
+      case PLIC_CLAIM: {
+        if (!claim)
+          return 0;
+
+        int source = best_source(context);
+        if (source != 0) {
+          pending &= ~(1u << source);
+          in_flight |= 1u << source;
+
+          uint64_t latency = now - request_cycle[source];
+          stats[source].claims++;
+          stats[source].total_latency += latency;
+          if (latency > stats[source].max_latency)
+            stats[source].max_latency = latency;
+
+          update();
+        }
+        return source;
+      }
+
+      default:
+        return 0;
+    }
+  }
+
+  return 0;
+}
+
+void Plic::write_register(MemoryAddress offset, uint32_t data) {
+  if (offset < PLIC_PENDING) {
+    if (offset / 4 < NUM_SOURCES && offset / 4 != 0)
+      priority[offset / 4] = data & PLIC_MAX_PRIORITY;
+  }
+  else if (offset >= PLIC_ENABLE && offset < PLIC_CONTEXT) {
+    MemoryAddress context = (offset - PLIC_ENABLE) / PLIC_ENABLE_STRIDE;
+    bool first_word = ((offset - PLIC_ENABLE) % PLIC_ENABLE_STRIDE) == 0;
+    if (context < NUM_CONTEXTS && first_word)
+      enable[context] = data & ~1u;  // Source 0 doesn't exist.
+  }
+  else if (offset >= PLIC_CONTEXT) {
+    MemoryAddress context = (offset - PLIC_CONTEXT) / PLIC_CONTEXT_STRIDE;
+    if (context >= NUM_CONTEXTS)
+      return;
+
+    switch ((offset - PLIC_CONTEXT) % PLIC_CONTEXT_STRIDE) {
+      case PLIC_THRESHOLD:
+        threshold[context] = data & PLIC_MAX_PRIORITY;
+        break;
+
+      case PLIC_CLAIM:
+        // Completion. The gateway can now accept another request.
+        if (data < NUM_SOURCES)
+          in_flight &= ~(1u << data);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  update();
+}
+
+void Plic::print_report(std::ostream& os) const {
+  os << "External interrupts:\n";
+  os << "  " << setw(8) << "source" << setw(12) << "requests" << setw(12)
+     << "coalesced" << setw(12) << "claimed" << setw(14) << "mean latency"
+     << setw(14) << "max latency" << "\n";
+
+  for (int i=1; i<NUM_SOURCES; i++) {
+    const source_stats_t& source = stats[i];
+    if (source.requests == 0 && source.coalesced == 0)
+      continue;
+
+    os << "  " << setw(8) << i << setw(12) << source.requests
+       << setw(12) << source.coalesced << setw(12) << source.claims
+       << setw(14) << std::fixed << std::setprecision(1)
+       << (source.claims == 0 ? 0.0 : (double)source.total_latency / source.claims)
+       << setw(14) << source.max_latency << "\n";
+  }
+}
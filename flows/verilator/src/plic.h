@@ -0,0 +1,141 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Platform-level interrupt controller, in the SiFive PLIC layout, with
+// external interrupt sources driven either by other devices or by a stimulus
+// file.
+//
+// There are two contexts: hart 0 machine mode (driving `mip.MEIP`) and hart 0
+// supervisor mode (`mip.SEIP`). Each source has a gateway which allows one
+// request at a time: a new request is only accepted once the previous one has
+// been claimed and completed.
+
+#ifndef PLIC_H
+#define PLIC_H
+
+#include <cstdint>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "memory_mapped_device.h"
+
+using std::string;
+using std::vector;
+
+class Plic : public MemoryMappedDevice {
+public:
+
+  static const MemoryAddress DEFAULT_ADDRESS = 0x0c000000;
+
+  // Source 0 is reserved, so IDs 1-31 are usable.
+  static const int NUM_SOURCES = 32;
+  static const int NUM_CONTEXTS = 2;
+
+  Plic();
+
+  // Read a list of interrupt requests to inject. Each line is either
+  //   at <cycle> <source>
+  //   every <period> <source> [<first cycle> [<count>]]
+  // with cycles counted from the start of the program. Lines starting with
+  // '#' are ignored.
+  void set_stimulus(string filename);
+  bool has_stimulus() const {
+    return !stimulus.empty();
+  }
+
+  // Called once per clock cycle. Defined here so it can be inlined into the
+  // simulation loop.
+  void tick(uint64_t cycle) {
+    now = cycle;
+    if (now >= next_event)
+      fire_events();
+  }
+
+  // Drive a level-triggered source, e.g. from another device.
+  void set_level(int source, bool level) {
+    if (level && !((pending | in_flight) & (1u << source)))
+      request(source);
+  }
+
+  virtual uint64_t read(MemoryAddress offset, int num_bytes);
+  virtual void write(MemoryAddress offset, uint64_t data, int num_bytes);
+  virtual void reset();
+
+  // Interrupts requested, as a bitmask in the layout of `mip`.
+  uint32_t pending_interrupts() const {
+    return interrupts;
+  }
+
+  // Display, for each source which was used, the number of requests, how many
+  // arrived while the previous one was still outstanding, and the time taken
+  // for them to be claimed.
+  void print_report(std::ostream& os) const;
+
+  // Discard statistics.
+  void clear();
+
+private:
+
+  typedef struct {
+    uint64_t cycle;   // Relative to the start of the program.
+    int      source;
+    uint64_t period;  // 0 for a single request.
+    uint64_t count;   // Requests remaining, including this one.
+  } stimulus_t;
+
+  struct later {
+    bool operator()(const stimulus_t& a, const stimulus_t& b) const {
+      return a.cycle > b.cycle;
+    }
+  };
+
+  typedef struct {
+    uint64_t requests;
+    uint64_t coalesced;
+    uint64_t claims;
+    uint64_t total_latency;  // Sum of cycles from request to claim.
+    uint64_t max_latency;
+  } source_stats_t;
+
+  // Raise all requests due at or before `now`, and schedule the next ones.
+  void fire_events();
+
+  // Pass a request through a source's gateway.
+  void request(int source);
+
+  // Highest-priority request which `context` may claim, or 0.
+  int best_source(int context) const;
+
+  // Recompute `interrupts` after any state change.
+  void update();
+
+  // Only an aligned 32-bit read of a claim register may `claim` an interrupt.
+  // Other reads of it return 0.
+  uint32_t read_register(MemoryAddress offset, bool claim);
+  void write_register(MemoryAddress offset, uint32_t data);
+
+  uint64_t now;
+  uint64_t start_cycle;
+
+  uint32_t priority[NUM_SOURCES];
+  uint32_t enable[NUM_CONTEXTS];
+  uint32_t threshold[NUM_CONTEXTS];
+
+  uint32_t pending;    // Waiting to be claimed.
+  uint32_t in_flight;  // Claimed, but not yet completed.
+
+  uint32_t interrupts;
+
+  vector<stimulus_t> stimulus;
+  std::priority_queue<stimulus_t, vector<stimulus_t>, later> events;
+  uint64_t next_event;  // Absolute cycle, or UINT64_MAX if none.
+
+  uint64_t request_cycle[NUM_SOURCES];
+  source_stats_t stats[NUM_SOURCES];
+
+};
+
+#endif  // PLIC_H
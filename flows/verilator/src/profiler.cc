@@ -0,0 +1,62 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+#include "logs.h"
+#include "profiler.h"
+
+using std::map;
+using std::ofstream;
+
+Profiler::Profiler() {
+  interval = 1;
+  symbols = NULL;
+  clear();
+}
+
+void Profiler::set_interval(uint64_t interval) {
+  this->interval = (interval > 0) ? interval : 1;
+}
+
+void Profiler::set_symbols(const SymbolTable& symbols) {
+  this->symbols = &symbols;
+}
+
+void Profiler::clear() {
+  cycles_since_sample = 0;
+  block_samples.clear();
+
+  // Anything before the first jump is attributed to address 0.
+  previous_pc = 0;
+  current_block = &block_samples[0];
+}
+
+void Profiler::write_folded(string filename) const {
+  ofstream file(filename);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to write profile to " << filename << endl;
+    return;
+  }
+
+  // Sort output by address so related blocks appear together.
+  map<MemoryAddress, uint64_t> sorted(block_samples.begin(),
+                                      block_samples.end());
+
+  for (auto& block : sorted) {
+    if (block.second == 0)
+      continue;
+
+    string function = (symbols == NULL) ? "[unknown]"
+                                        : symbols->function_name(block.first);
+
+    file << function << ";0x" << std::hex << block.first
+         << std::dec << " " << (block.second * interval) << "\n";
+  }
+
+  file.close();
+}
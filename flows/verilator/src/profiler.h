@@ -0,0 +1,74 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Attribute simulated clock cycles to the code being executed.
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "symbol_table.h"
+#include "types.h"
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+// Cycles are recorded against dynamic basic blocks: a new block starts
+// whenever the program counter does anything other than step to the next
+// instruction. Stall cycles are attributed to the stalled instruction's block.
+class Profiler {
+public:
+
+  Profiler();
+
+  // Record every `interval`th cycle. Each sample represents `interval` cycles.
+  void set_interval(uint64_t interval);
+
+  // Provide symbols to use when describing results.
+  void set_symbols(const SymbolTable& symbols);
+
+  // Discard all samples.
+  void clear();
+
+  // Called once per clock cycle. Defined here so it can be inlined into the
+  // simulation loop.
+  void sample(MemoryAddress pc) {
+    if (pc != previous_pc) {
+      // 2 or 4 byte step = next instruction in the same block.
+      if (pc < previous_pc || pc > previous_pc + 4)
+        current_block = &block_samples[pc];
+      previous_pc = pc;
+    }
+
+    if (++cycles_since_sample >= interval) {
+      cycles_since_sample = 0;
+      (*current_block)++;
+    }
+  }
+
+  // Write results in the "folded stacks" format used by flamegraph.pl and
+  // speedscope. Each line holds "function;block cycles".
+  void write_folded(string filename) const;
+
+private:
+
+  uint64_t interval;
+  uint64_t cycles_since_sample;
+
+  MemoryAddress previous_pc;
+
+  // Samples taken in each basic block, indexed by the block's first address.
+  // Pointers to elements remain valid as the map grows.
+  unordered_map<MemoryAddress, uint64_t> block_samples;
+  uint64_t* current_block;
+
+  const SymbolTable* symbols;
+
+};
+
+#endif  // PROFILER_H
@@ -0,0 +1,128 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <sstream>
+
+#include "register_names.h"
+
+static const char* gpr_names[32] = {
+  "zero", "ra", "sp",  "gp",  "tp", "t0", "t1", "t2",
+  "s0",   "s1", "a0",  "a1",  "a2", "a3", "a4", "a5",
+  "a6",   "a7", "s2",  "s3",  "s4", "s5", "s6", "s7",
+  "s8",   "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+};
+
+static const char* fpr_names[32] = {
+  "ft0", "ft1", "ft2",  "ft3",  "ft4", "ft5", "ft6",  "ft7",
+  "fs0", "fs1", "fa0",  "fa1",  "fa2", "fa3", "fa4",  "fa5",
+  "fa6", "fa7", "fs2",  "fs3",  "fs4", "fs5", "fs6",  "fs7",
+  "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"
+};
+
+const char* gpr_name(int index) {
+  return gpr_names[index & 31];
+}
+
+const char* fpr_name(int index) {
+  return fpr_names[index & 31];
+}
+
+// Name, followed by the index relative to the start of a numbered range.
+static string numbered(const char* name, int index, const char* suffix="") {
+  std::stringstream ss;
+  ss << name << index << suffix;
+  return ss.str();
+}
+
+string csr_name(int index) {
+  switch (index) {
+    case 0x000: return "ustatus";
+    case 0x001: return "fflags";
+    case 0x002: return "frm";
+    case 0x003: return "fcsr";
+    case 0x004: return "uie";
+    case 0x005: return "utvec";
+    case 0x040: return "uscratch";
+    case 0x041: return "uepc";
+    case 0x042: return "ucause";
+    case 0x043: return "utval";
+    case 0x044: return "uip";
+    case 0x100: return "sstatus";
+    case 0x102: return "sedeleg";
+    case 0x103: return "sideleg";
+    case 0x104: return "sie";
+    case 0x105: return "stvec";
+    case 0x106: return "scounteren";
+    case 0x140: return "sscratch";
+    case 0x141: return "sepc";
+    case 0x142: return "scause";
+    case 0x143: return "stval";
+    case 0x144: return "sip";
+    case 0x180: return "satp";
+    case 0x200: return "hstatus";
+    case 0x202: return "hedeleg";
+    case 0x203: return "hideleg";
+    case 0x204: return "hie";
+    case 0x205: return "htvec";
+    case 0x240: return "hscratch";
+    case 0x241: return "hepc";
+    case 0x242: return "hcause";
+    case 0x243: return "hbadaddr";
+    case 0x244: return "hip";
+    case 0x300: return "mstatus";
+    case 0x301: return "misa";
+    case 0x302: return "medeleg";
+    case 0x303: return "mideleg";
+    case 0x304: return "mie";
+    case 0x305: return "mtvec";
+    case 0x306: return "mcounteren";
+    case 0x320: return "mcountinhibit";
+    case 0x340: return "mscratch";
+    case 0x341: return "mepc";
+    case 0x342: return "mcause";
+    case 0x343: return "mtval";
+    case 0x344: return "mip";
+    case 0x380: return "mbase";
+    case 0x381: return "mbound";
+    case 0x382: return "mibase";
+    case 0x383: return "mibound";
+    case 0x384: return "mdbase";
+    case 0x385: return "mdbound";
+    case 0x7a0: return "tselect";
+    case 0x7a1: return "tdata1";
+    case 0x7a2: return "tdata2";
+    case 0x7a3: return "tdata3";
+    case 0x7b0: return "dcsr";
+    case 0x7b1: return "dpc";
+    case 0x7b2: return "dscratch";
+    case 0xb00: return "mcycle";
+    case 0xb02: return "minstret";
+    case 0xb80: return "mcycleh";
+    case 0xb82: return "minstreth";
+    case 0xc00: return "cycle";
+    case 0xc01: return "time";
+    case 0xc02: return "instret";
+    case 0xc80: return "cycleh";
+    case 0xc81: return "timeh";
+    case 0xc82: return "instreth";
+    case 0xf11: return "mvendorid";
+    case 0xf12: return "marchid";
+    case 0xf13: return "mimpid";
+    case 0xf14: return "mhartid";
+    default: break;
+  }
+
+  if (index >= 0xc03 && index <= 0xc1f) return numbered("hpmcounter", index - 0xc00);
+  if (index >= 0xc83 && index <= 0xc9f) return numbered("hpmcounter", index - 0xc80, "h");
+  if (index >= 0xb03 && index <= 0xb1f) return numbered("mhpmcounter", index - 0xb00);
+  if (index >= 0xb83 && index <= 0xb9f) return numbered("mhpmcounter", index - 0xb80, "h");
+  if (index >= 0x323 && index <= 0x33f) return numbered("mhpmevent", index - 0x320);
+  if (index >= 0x3a0 && index <= 0x3a3) return numbered("pmpcfg", index - 0x3a0);
+  if (index >= 0x3b0 && index <= 0x3bf) return numbered("pmpaddr", index - 0x3b0);
+
+  // Unnamed CSRs are shown as their address.
+  std::stringstream ss;
+  ss << "0x" << std::hex << index;
+  return ss.str();
+}
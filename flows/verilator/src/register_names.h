@@ -0,0 +1,23 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Assembly names of registers and CSRs, as used in riscv-dv traces.
+
+#ifndef REGISTER_NAMES_H
+#define REGISTER_NAMES_H
+
+#include <string>
+
+using std::string;
+
+// ABI name of integer register `index`, e.g. "a0".
+const char* gpr_name(int index);
+
+// ABI name of floating point register `index`, e.g. "fa0".
+const char* fpr_name(int index);
+
+// Name of the CSR at address `index`, e.g. "mstatus".
+string csr_name(int index);
+
+#endif  // REGISTER_NAMES_H
@@ -7,7 +7,10 @@
 
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <fstream>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <verilated.h>
 
 // Verilator doesn't allow VCD and FST tracing simultaneously.
@@ -21,12 +24,30 @@
 #endif
 
 #include "argument_parser.h"
+#include "batch.h"
 #include "binary_parser.h"
+#include "branch_statistics.h"
+#include "clint.h"
+#include "commit_log_checker.h"
+#include "console.h"
+#include "disassembler.h"
 #include "exceptions.h"
+#include "interrupt_latency.h"
 #include "logs.h"
 #include "main_memory.h"
-
+#include "performance_events.h"
+#include "plic.h"
+#include "profiler.h"
+#include "register_names.h"
+#include "statistics.h"
+#include "symbol_table.h"
+#include "system_calls.h"
+#include "uart.h"
+
+using std::ifstream;
+using std::map;
 using std::ofstream;
+using std::pair;
 using std::string;
 
 template<class DUT>
@@ -43,6 +64,7 @@ public:
     args.add_argument("--coverage", "Dump coverage information to a file", ArgumentParser::ARGS_ONE);
     args.add_argument("-v", "Display basic logging information as simulation proceeds");
     args.add_argument("-vv", "Display detailed logging information as simulation proceeds");
+    args.add_argument("--log", "Restrict logging to a comma-separated list of categories (sim, memory, ports, ptw, tilelink)", ArgumentParser::ARGS_ONE);
     args.add_argument("--help", "Display this information and exit");
 
 #ifdef FST_ENABLE
@@ -165,6 +187,14 @@ public:
       log_level = 1;
     if (args.found_arg("-vv"))
       log_level = 2;
+    if (args.found_arg("--log"))
+      set_log_categories(args.get_arg("--log"));
+
+    if (log_level > MUNTJAC_MAX_LOG_LEVEL)
+      MUNTJAC_WARN << "Logging above level " << MUNTJAC_MAX_LOG_LEVEL
+          << " was removed at compile time" << endl;
+    if (log_level > 0)
+      log_buffer_output();
     
     if (args.found_arg("--help")) {
       args.print_help();
@@ -218,14 +248,54 @@ class RISCVSimulation : public Simulation<DUT> {
 public:
 
   RISCVSimulation(string name) : 
-      Simulation<DUT>(name) {
+      Simulation<DUT>(name),
+      syscalls(memory),
+      uart(console) {
     main_memory_latency = 10;
+    stack_top = DEFAULT_STACK_TOP;
     csv_on = false;
+    cosim_on = false;
+    stats_on = false;
+    profile_on = false;
+    cpi_stack_on = false;
+    branch_stats_on = false;
+    branch_stats_count = 0;
+    irq_latency_on = false;
+    batch_on = false;
+    batch_pass_code = 1;
+    jobs = 1;
     exit_code = 0;
+    binary_position = 0;
+
+    profiler.set_symbols(symbols);
+    memory.add_device(uart);
+    memory.add_device(clint);
+    memory.add_device(plic);
 
     this->args.set_description("Usage: " + name + " [simulator args] <program> [program args]");
     this->args.add_argument("--memory-latency", "Set main memory latency to a given number of cycles", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--clint-address", "Base address of the CLINT (default 0x2000000)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--timebase", "Number of clock cycles per increment of mtime (default 1)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--plic-address", "Base address of the PLIC (default 0xc000000)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--plic-stimulus", "Inject external interrupts at times listed in a file", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--irq-latency", "Display histograms of cycles between interrupt requests and handler entry");
+    this->args.add_argument("--uart-address", "Base address of the 16550 UART (default 0x10000000)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--console-output", "Write the program's console output to a file instead of stdout", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--console-input", "Supply the program's console input from a file", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--console-timestamps", "Prefix each line of console output with the current cycle");
+    this->args.add_argument("--stack-top", "Address above the program's initial stack (default 0x80000000)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--env", "Pass environment variables to the program, read from a file containing one NAME=value per line", ArgumentParser::ARGS_ONE);
     this->args.add_argument("--csv", "Dump a CSV trace to a file (mainly for riscv-dv)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--cosim", "Compare each instruction with a reference trace in riscv-dv CSV format, and stop at the first divergence", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--stats-json", "Dump simulator performance statistics to a JSON file", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--profile", "Dump cycles spent in each function and basic block to a file (folded stacks format)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--profile-interval", "Sample the program counter every N cycles when profiling (default 1)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--branch-stats", "Display the given number of most-mispredicted branches, and estimate accuracy of other predictor sizes", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--cpi-stack", "Display a breakdown of cycles per instruction at the end of each program");
+    this->args.add_argument("--batch", "Execute each program listed in a file, one per line", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--batch-pass", "Exit argument which indicates success in batch mode (default 1)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--jobs", "Number of batch programs to execute in parallel", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--junit", "Write a JUnit XML report of batch results to a file", ArgumentParser::ARGS_ONE);
   }
 
 protected:
@@ -234,6 +304,34 @@ protected:
   virtual MemoryAddress get_program_counter() = 0;
   virtual instr_trace_t get_trace_info() = 0;
 
+  // One bit for each hardware performance monitor event active this cycle.
+  virtual uint32_t get_performance_events() = 0;
+
+  // Branch resolution and misprediction information for this cycle.
+  virtual branch_trace_t get_branch_trace() = 0;
+
+  // Trap information for this cycle.
+  virtual trap_trace_t get_trap_trace() = 0;
+
+  // Drive the core's interrupt inputs. `pending` uses the layout of `mip`.
+  virtual void set_interrupts(uint32_t pending) = 0;
+
+  // The model has a write-back data cache, so main memory may not hold the
+  // program's latest data.
+  virtual bool has_data_cache() const {return false;}
+
+  // Evaluate the Verilator model. Subclasses should use this instead of
+  // `dut.eval()` so host time can be attributed correctly.
+  void eval() {
+    if (stats_on)
+      stats.eval.start();
+
+    this->dut.eval();
+
+    if (stats_on)
+      stats.eval.stop();
+  }
+
   // Initialise all active traces.
   virtual void trace_init() {
     Simulation<DUT>::trace_init();
@@ -241,10 +339,12 @@ protected:
     if (csv_on) {
       csv_trace.open(csv_filename);
 
-      // This is a subset of the required fields for riscv-dv. The remaining
-      // ones are added in with a separate script which can decode instructions.
-      csv_trace << "pc,gpr,csr,binary,mode\n";
+      // The trace format used by riscv-dv.
+      csv_trace << "pc,instr,gpr,csr,binary,mode,instr_str,operand,pad\n";
     }
+
+    if (cosim_on)
+      cosim.open(cosim_filename);
   }
 
   // Dump information after state has changed.
@@ -254,10 +354,17 @@ protected:
     // TODO: ensure this is happening on the expected clock edge.
     if (get_program_counter() != pc) {
       pc = get_program_counter();
+      stats.instructions++;
       MUNTJAC_LOG(1) << "PC: 0x" << std::hex << pc << std::dec << endl;
 
-      if (csv_on)
-        csv_output_line(csv_trace);
+      if (csv_on || cosim_on) {
+        instr_trace_t trace = get_trace_info();
+
+        if (csv_on)
+          csv_output_line(csv_trace, trace);
+        if (cosim_on && !cosim.check(trace))
+          cosim_divergence();
+      }
     }
   }
 
@@ -278,60 +385,321 @@ public:
   }
 
   void run() {
-    pc = 0;
+    // Parallel batches run in child processes, which can't share trace files.
+    if (batch_on && jobs > 1) {
+      run_batch();
+      this->end_simulation();
+
+      if (stats_on)
+        stats.write_json(stats_filename);
+
+      return;
+    }
 
     this->trace_init();
 
+    if (batch_on)
+      run_batch();
+    else
+      run_program();
+
+    this->end_simulation();
+
+    this->trace_close();
+
+    if (stats_on)
+      stats.write_json(stats_filename);
+
+    if (profile_on)
+      profiler.write_folded(profile_filename);
+
+    if (!batch_on && stats.timed_out) {
+      MUNTJAC_ERROR << "Simulation timed out after " << this->timeout << " cycles" << endl;
+      exit(1);
+    }
+
+  }
+
+  // Reset the core and execute the currently-loaded program until it exits or
+  // times out. Simulation time keeps increasing across programs so traces
+  // remain consistent.
+  void run_program() {
+    pc = 0;
+    exit_code = 0;
+    Verilated::gotFinish(false);
+
     this->init();
     this->reset();
     
     this->cycle_second_half();
 
-    while (!Verilated::gotFinish() && this->cycle < this->timeout) {
+    uint64_t start_cycle = this->cycle;
+    uint64_t start_instructions = stats.instructions;
+    stats.wall.start();
+
+    while (!Verilated::gotFinish() && 
+           (this->cycle - start_cycle) < this->timeout) {
       this->set_clock(1);
-      this->cycle_first_half();
-      this->trace_state_change();
+      half_cycle(true);
       this->cycle += 0.5;
 
       this->set_clock(0);
-      this->cycle_second_half();
-      this->trace_state_change();
+      half_cycle(false);
       this->cycle += 0.5;
+
+      clint.tick(this->cycle);
+      plic.tick(this->cycle);
+      plic.set_level(UART_INTERRUPT_SOURCE, uart.interrupt_pending());
+      uint32_t interrupts = clint.pending_interrupts() |
+                            plic.pending_interrupts();
+      set_interrupts(interrupts);
+
+      if (profile_on)
+        profiler.sample(get_program_counter());
+      if (cpi_stack_on)
+        performance_events.sample(get_performance_events());
+      if (branch_stats_on)
+        branch_stats.sample(get_branch_trace());
+      if (irq_latency_on)
+        interrupt_latency.sample(this->cycle, interrupts, get_trap_trace(),
+                                 get_program_counter());
     }
 
-    this->end_simulation();
+    stats.wall.stop();
+    console.flush();
+    stats.cycles = this->cycle;
+    stats.exit_code = exit_code;
+    stats.timed_out = (this->cycle - start_cycle) >= this->timeout;
 
-    this->trace_close();
+    if (cpi_stack_on) {
+      performance_events.print_cpi_stack(log_stream, this->cycle - start_cycle,
+                                         stats.instructions - start_instructions);
+      performance_events.clear();
+    }
 
-    if (this->cycle >= this->timeout) {
-      MUNTJAC_ERROR << "Simulation timed out after " << this->timeout << " cycles" << endl;
-      exit(1);
+    if (branch_stats_on) {
+      branch_stats.print_report(log_stream, symbols, branch_stats_count);
+      branch_stats.clear();
+    }
+
+    if (irq_latency_on) {
+      interrupt_latency.print_report(log_stream);
+      interrupt_latency.clear();
+    }
+
+    if (plic.has_stimulus()) {
+      plic.print_report(log_stream);
+      plic.clear();
+    }
+  }
+
+  // Execute a single entry of a batch list, starting from an empty memory.
+  batch_result_t run_batch_entry(const batch_entry_t& entry) {
+    batch_result_t result;
+    result.name = batch_entry_name(entry);
+
+    uint64_t start_cycles = stats.cycles;
+    uint64_t start_instructions = stats.instructions;
+    double start_seconds = stats.wall.seconds();
+
+    MUNTJAC_LOG(0) << "Running " << result.name << endl;
+
+    try {
+      load_program(entry);
+      run_program();
+
+      result.exit_code = exit_code;
+      result.timed_out = stats.timed_out;
+    }
+    catch (const std::exception& e) {
+      MUNTJAC_ERROR << result.name << ": " << e.what() << endl;
+      result.exit_code = -1;
+      result.timed_out = false;
+    }
+
+    result.passed = !result.timed_out && (result.exit_code == batch_pass_code);
+    result.cycles = stats.cycles - start_cycles;
+    result.instructions = stats.instructions - start_instructions;
+    result.seconds = stats.wall.seconds() - start_seconds;
+
+    return result;
+  }
+
+  // Execute every program in the batch list in turn, reusing the same model.
+  vector<batch_result_t> run_batch_sequential() {
+    vector<batch_result_t> results;
+
+    for (auto& entry : batch)
+      results.push_back(run_batch_entry(entry));
+
+    return results;
+  }
+
+  // Execute up to `jobs` batch entries at a time. The model is constructed
+  // once, then each entry runs in a forked child process which shares the
+  // parent's initial state copy-on-write. Each child sends its result back
+  // through a pipe and exits.
+  vector<batch_result_t> run_batch_parallel() {
+    vector<batch_result_t> results(batch.size());
+
+    // Map child process to the read end of its pipe and its batch entry.
+    map<pid_t, pair<int, size_t>> running;
+    size_t next_entry = 0;
+
+    stats.wall.start();
+
+    while (next_entry < batch.size() || !running.empty()) {
+      // Start as many children as allowed.
+      while (next_entry < batch.size() && running.size() < (size_t)jobs) {
+        size_t index = next_entry++;
+        results[index].name = batch_entry_name(batch[index]);
+
+        int fds[2];
+        if (pipe(fds) != 0) {
+          MUNTJAC_ERROR << "Unable to create pipe for batch job" << endl;
+          exit(1);
+        }
+
+        // Don't let buffered output be duplicated in the child.
+        cout.flush();
+        log_flush();
+
+        pid_t pid = fork();
+
+        if (pid < 0) {
+          MUNTJAC_ERROR << "Unable to fork batch job" << endl;
+          exit(1);
+        }
+        else if (pid == 0) {
+          close(fds[0]);
+          stats.clear();
+          batch_result_t result = run_batch_entry(batch[index]);
+          send_batch_result(fds[1], result);
+          close(fds[1]);
+
+          cout.flush();
+          log_flush();
+          _exit(0);
+        }
+
+        close(fds[1]);
+        running[pid] = pair<int, size_t>(fds[0], index);
+      }
+
+      // Collect the result of any child which finishes.
+      int status;
+      pid_t pid = waitpid(-1, &status, 0);
+      if (running.find(pid) == running.end())
+        continue;
+
+      int fd = running[pid].first;
+      batch_result_t& result = results[running[pid].second];
+
+      if (!receive_batch_result(fd, result)) {
+        MUNTJAC_ERROR << result.name << ": simulator process terminated early"
+            << endl;
+        result.exit_code = -1;
+        result.timed_out = false;
+        result.passed = false;
+        result.cycles = 0;
+        result.instructions = 0;
+        result.seconds = 0;
+      }
+
+      close(fd);
+      running.erase(pid);
+
+      stats.cycles += result.cycles;
+      stats.instructions += result.instructions;
     }
 
+    stats.wall.stop();
+
+    return results;
+  }
+
+  // Execute every program in the batch list, reusing the same model.
+  void run_batch() {
+    vector<batch_result_t> results = (jobs > 1) ? run_batch_parallel()
+                                                : run_batch_sequential();
+
+    int failures = 0;
+    for (auto& result : results)
+      if (!result.passed)
+        failures++;
+
+    MUNTJAC_LOG(0) << "Batch complete: " << (results.size() - failures) << "/"
+        << results.size() << " passed" << endl;
+
+    if (!junit_filename.empty())
+      write_junit_xml(junit_filename, this->name, results);
+
+    stats.program = batch_filename;
+    stats.exit_code = exit_code = (failures > 0);
+    stats.timed_out = false;
   }
 
   void reset() {
     Simulation<DUT>::reset();
-    set_entry_point(entry_point);
+    set_entry_point(entry_point, stack_pointer);
+    memory.reset_devices();
   }
 
+  // The program acknowledges responses by writing to `fromhost`, so only
+  // writes to `tohost` are requests.
   bool is_system_call(MemoryAddress address, uint64_t write_data) {
-    return (address == tohost) || (address == fromhost);
+    return address == tohost;
   }
 
-  // This behaviour is probably specific to riscv-tests.
+  // HTIF protocol: the top byte selects a device, the next byte a command, and
+  // the remaining bits are the payload.
   void system_call(MemoryAddress address, uint64_t write_data) {
     assert(is_system_call(address, write_data));
 
+    uint8_t device = write_data >> 56;
+    uint8_t command = write_data >> 48;
+    uint64_t payload = write_data & 0xffffffffffff;
+
+    // tohost cleared: nothing to do
+    if (write_data == 0)
+      return;
     // putchar
-    if ((write_data & 0xffffffffffffff00) == 0x101000000000000)
-      putchar(write_data & 0xff);
-    // exit
-    else {
-      MUNTJAC_LOG(0) << "Exiting with argument " << write_data << endl;
-      exit_code = write_data;
+    else if (device == 1 && command == 1)
+      console.put(payload & 0xff);
+    // exit: an odd payload holds (exit code << 1) | 1
+    else if (device != 0 || command != 0 || (payload & 1))
+      program_exit(write_data);
+    // system call: the payload points to the arguments. The arguments and
+    // buffers may be held in the data cache, out of the simulator's reach.
+    else if (has_data_cache()) {
+      MUNTJAC_ERROR << "System calls are not supported by this model: its data "
+                    << "cache hides the program's buffers from the simulator. "
+                    << "Use muntjac_pipeline instead." << endl;
+      exit_code = -1;
       Verilated::gotFinish(true);
     }
+    else {
+      syscalls.execute(payload);
+
+      if (syscalls.exited())
+        program_exit((syscalls.exit_argument() << 1) | 1);
+      else
+        memory.write64(fromhost, 1);
+    }
+  }
+
+  // Stop the program when it no longer matches the reference trace.
+  void cosim_divergence() {
+    MUNTJAC_ERROR << "Co-simulation failed" << endl;
+    cosim.print_divergence(cerr);
+    exit_code = -1;
+    Verilated::gotFinish(true);
+  }
+
+  void program_exit(int64_t argument) {
+    MUNTJAC_LOG(0) << "Exiting with argument " << argument << endl;
+    exit_code = argument;
+    Verilated::gotFinish(true);
   }
 
   virtual void parse_args(int argc, char** argv) {
@@ -344,6 +712,7 @@ public:
 
     // If we found an unknown argument and it doesn't look like a flag, assume
     // it's the binary to execute.
+    binary_position = argc;
     if (this->args.get_args_parsed() < argc) {
       int pos = this->args.get_args_parsed();
       string name(argv[pos]);
@@ -356,52 +725,210 @@ public:
 
     if (this->args.found_arg("--memory-latency"))
       main_memory_latency = std::stoi(this->args.get_arg("--memory-latency"));
-    
+
+    if (this->args.found_arg("--stack-top"))
+      stack_top = std::stoull(this->args.get_arg("--stack-top"), nullptr, 0);
+
+    if (this->args.found_arg("--env"))
+      read_environment(this->args.get_arg("--env"));
+
+    if (this->args.found_arg("--clint-address"))
+      clint.set_base_address(std::stoull(this->args.get_arg("--clint-address"), nullptr, 0));
+
+    if (this->args.found_arg("--timebase"))
+      clint.set_timebase(std::stoull(this->args.get_arg("--timebase")));
+
+    if (this->args.found_arg("--plic-address"))
+      plic.set_base_address(std::stoull(this->args.get_arg("--plic-address"), nullptr, 0));
+
+    if (this->args.found_arg("--plic-stimulus"))
+      plic.set_stimulus(this->args.get_arg("--plic-stimulus"));
+
+    if (this->args.found_arg("--irq-latency"))
+      irq_latency_on = true;
+
+    if (this->args.found_arg("--uart-address"))
+      uart.set_base_address(std::stoull(this->args.get_arg("--uart-address"), nullptr, 0));
+
+    if (this->args.found_arg("--console-output"))
+      console.set_output(this->args.get_arg("--console-output"));
+
+    if (this->args.found_arg("--console-input"))
+      console.set_input(this->args.get_arg("--console-input"));
+
+    if (this->args.found_arg("--console-timestamps"))
+      console.set_timestamps(true);
+
     if (this->args.found_arg("--csv")) {
       csv_filename = this->args.get_arg("--csv");
       csv_on = true;
     }
 
-    read_binary(argc - binary_position, argv + binary_position);
+    if (this->args.found_arg("--stats-json")) {
+      stats_filename = this->args.get_arg("--stats-json");
+      stats_on = true;
+    }
+
+    if (this->args.found_arg("--profile")) {
+      profile_filename = this->args.get_arg("--profile");
+      profile_on = true;
+    }
+
+    if (this->args.found_arg("--profile-interval"))
+      profiler.set_interval(std::stoull(this->args.get_arg("--profile-interval")));
+
+    if (this->args.found_arg("--cpi-stack"))
+      cpi_stack_on = true;
+
+    if (this->args.found_arg("--branch-stats")) {
+      branch_stats_count = std::stoi(this->args.get_arg("--branch-stats"));
+      branch_stats_on = true;
+    }
+
+    if (this->args.found_arg("--batch")) {
+      batch_filename = this->args.get_arg("--batch");
+      batch = read_batch_list(batch_filename);
+      batch_on = true;
+    }
+
+    if (this->args.found_arg("--batch-pass"))
+      batch_pass_code = std::stoi(this->args.get_arg("--batch-pass"));
+
+    if (this->args.found_arg("--junit"))
+      junit_filename = this->args.get_arg("--junit");
+
+    if (this->args.found_arg("--jobs"))
+      jobs = std::stoi(this->args.get_arg("--jobs"));
+
+    if (batch_on && profile_on) {
+      MUNTJAC_ERROR << "Profiling is not supported in batch mode" << endl;
+      exit(1);
+    }
+
+    if (this->args.found_arg("--cosim")) {
+      cosim_filename = this->args.get_arg("--cosim");
+      cosim_on = true;
+    }
+
+    if (cosim_on && batch_on) {
+      MUNTJAC_ERROR << "--cosim checks a single program, so is not supported with --batch" << endl;
+      exit(1);
+    }
+
+    if (jobs > 1 && (csv_on || this->args.found_arg("--vcd") ||
+                     this->args.found_arg("--fst") ||
+                     this->args.found_arg("--coverage"))) {
+      MUNTJAC_ERROR << "Tracing and coverage are not supported with --jobs" << endl;
+      exit(1);
+    }
+
+    // In batch mode, programs are loaded one at a time as they are executed.
+    if (!batch_on)
+      read_binary(argc - binary_position, argv + binary_position);
   }
 
 private:
 
-  void csv_output_line(ofstream& file) {
-    instr_trace_t trace = get_trace_info();
+  // Simulate half of a clock cycle, recording host time if requested.
+  void half_cycle(bool first_half) {
+    if (stats_on)
+      stats.harness.start();
+
+    if (first_half)
+      this->cycle_first_half();
+    else
+      this->cycle_second_half();
+
+    if (stats_on) {
+      stats.harness.stop();
+      stats.trace.start();
+    }
+
+    this->trace_state_change();
+
+    if (stats_on)
+      stats.trace.stop();
+  }
+
+  void csv_output_line(ofstream& file, const instr_trace_t& trace) {
+    disassembly_t instr = disassemble(trace.instr_word);
 
-    // This is a subset of the required fields for riscv-dv. The remaining
-    // ones are added in with a separate script which can decode instructions.
-    // The register indices will also need to be translated to names.
     file << std::hex << std::setfill('0');
 
     file << std::setw(16) << trace.pc << ",";
+    file << instr.name << ",";
     if (trace.gpr_written && trace.gpr != 0)
-      file << trace.gpr << ":" << std::setw(16) << trace.gpr_data;
+      file << gpr_name(trace.gpr) << ":" << std::setw(16) << trace.gpr_data;
     file << ",";
     if (trace.csr_written)
-      file << trace.csr << ":" << std::setw(16) << trace.csr_data;
+      file << csr_name(trace.csr) << ":" << std::setw(16) << trace.csr_data;
     file << ",";
     file << std::setw(8) << trace.instr_word << ",";
-    file << trace.mode << "\n";
+    file << trace.mode << ",";
+
+    // Operands are separated by commas, so must be quoted.
+    if (instr.operands.empty())
+      file << instr.name << ",,";
+    else
+      file << "\"" << instr.name << " " << instr.operands << "\",\""
+           << instr.operands << "\",";
+    file << "\n";
+  }
+
+  // Replace the contents of memory with a new program.
+  void load_program(const batch_entry_t& entry) {
+    vector<char*> argv;
+    for (auto& arg : entry)
+      argv.push_back(const_cast<char*>(arg.c_str()));
+
+    memory.clear();
+    read_binary(argv.size(), argv.data());
   }
 
   void read_binary(int argc, char** argv) {
-    BinaryParser::load_elf(argc, argv, memory);
-    entry_point = BinaryParser::entry_point(argv[0]);
+    if (argc < 1)
+      throw std::runtime_error("No binary file specified");
+
+    BinaryParser binary(argv[0]);
+    binary.load(memory);
+    binary.read_symbols(symbols);
+    stats.program = argv[0];
+    entry_point = binary.entry_point();
+    syscalls.reset(binary.end_address());
+    stack_pointer = binary.write_stack(argc, argv, environment, stack_top,
+                                       memory);
 
     // System calls: this may be specific to riscv-tests.
-    tohost = BinaryParser::symbol_location(argv[0], "tohost");
-    fromhost = BinaryParser::symbol_location(argv[0], "fromhost");
+    tohost = symbols.location("tohost");
+    fromhost = symbols.location("fromhost");
   }
 
-  void set_entry_point(MemoryAddress pc) {
-    // auipc a0, 0; ld a0, 16(a0)
-    memory.write64(0x00, 0x0105350300000517);
-    // jr a0
-    memory.write64(0x08, 0x0000000000008502);
+  void set_entry_point(MemoryAddress pc, MemoryAddress sp) {
+    // auipc t0, 0; ld sp, 24(t0)
+    memory.write64(0x00, 0x0182b10300000297);
+    // ld t0, 16(t0); jr t0
+    memory.write64(0x08, 0x000280670102b283);
     // target pc
     memory.write64(0x10, pc);
+    // initial stack pointer
+    memory.write64(0x18, sp);
+  }
+
+  // Read NAME=value lines from a file to form the program's environment.
+  void read_environment(string filename) {
+    ifstream file(filename);
+
+    if (!file.good()) {
+      MUNTJAC_ERROR << "Unable to read environment from " << filename << endl;
+      exit(1);
+    }
+
+    string line;
+    while (std::getline(file, line))
+      if (!line.empty() && line[0] != '#')
+        environment.push_back(line);
+
+    file.close();
   }
 
 protected:
@@ -413,6 +940,14 @@ protected:
   // Cycles between a request arriving at main memory and a response leaving.
   int main_memory_latency;
 
+  // The program's initial stack is built downwards from this address. The
+  // default is just below where RISC-V programs are usually linked.
+  static const MemoryAddress DEFAULT_STACK_TOP = 0x80000000;
+  MemoryAddress stack_top;
+
+  // Environment variables passed to the program, each "NAME=value".
+  vector<string> environment;
+
 private:
 
   MemoryAddress pc;
@@ -422,6 +957,63 @@ private:
   string csv_filename;
   ofstream csv_trace;
 
+  // Compare against a reference trace as instructions retire?
+  bool cosim_on;
+  string cosim_filename;
+  CommitLogChecker cosim;
+
+  // Dump host performance statistics?
+  bool stats_on;
+  string stats_filename;
+  SimulationStatistics stats;
+
+  // Record where simulated cycles are spent?
+  bool profile_on;
+  string profile_filename;
+  Profiler profiler;
+
+  // Report where cycles are lost?
+  bool cpi_stack_on;
+  PerformanceEvents performance_events;
+
+  // Report branch predictor accuracy?
+  bool branch_stats_on;
+  int branch_stats_count;
+  BranchStatistics branch_stats;
+
+  // Functions in the current program, for reports.
+  SymbolTable symbols;
+
+  // Host-side implementation of the program's system calls.
+  SystemCallProxy syscalls;
+
+  // Memory-mapped devices, and the host console they connect to.
+  Console console;
+  Uart16550 uart;
+  Clint clint;
+  Plic plic;
+
+  // PLIC source driven by the UART's interrupt output.
+  static const int UART_INTERRUPT_SOURCE = 10;
+
+  // Measure interrupt latency?
+  bool irq_latency_on;
+  InterruptLatency interrupt_latency;
+
+  // Execute many programs in one process?
+  bool batch_on;
+  string batch_filename;
+  vector<batch_entry_t> batch;
+
+  // Exit argument which indicates that a program passed.
+  int batch_pass_code;
+
+  // Maximum number of batch programs to execute in parallel.
+  int jobs;
+
+  // Write a JUnit report of batch results?
+  string junit_filename;
+
 // Simulation state.
 
   // Value to return when simulation finishes.
@@ -433,6 +1025,9 @@ private:
   // Memory address of the first instruction to be executed.
   MemoryAddress entry_point;
 
+  // Initial stack pointer, pointing to argc.
+  MemoryAddress stack_pointer;
+
   // Memory addresses to access for system calls.
   MemoryAddress tohost;
   MemoryAddress fromhost;
@@ -0,0 +1,97 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <fstream>
+#include <iomanip>
+
+#include "logs.h"
+#include "statistics.h"
+
+using std::ofstream;
+
+// Escape characters which are not allowed to appear in a JSON string.
+static string json_escape(const string& str) {
+  string result;
+
+  for (char c : str) {
+    switch (c) {
+      case '"':  result += "\\\""; break;
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n";  break;
+      case '\t': result += "\\t";  break;
+      default:   result += c;      break;
+    }
+  }
+
+  return result;
+}
+
+// Divide two values, avoiding division by zero for very short simulations.
+static double rate(double amount, double seconds) {
+  return (seconds > 0) ? (amount / seconds) : 0;
+}
+
+
+HostTimer::HostTimer() {
+  clear();
+}
+
+void HostTimer::clear() {
+  total = clock::duration::zero();
+}
+
+double HostTimer::seconds() const {
+  return std::chrono::duration<double>(total).count();
+}
+
+
+SimulationStatistics::SimulationStatistics() {
+  clear();
+}
+
+void SimulationStatistics::clear() {
+  program = "";
+  cycles = 0;
+  instructions = 0;
+  exit_code = 0;
+  timed_out = false;
+
+  wall.clear();
+  eval.clear();
+  harness.clear();
+  trace.clear();
+}
+
+void SimulationStatistics::write_json(string filename) const {
+  ofstream file(filename);
+
+  if (!file.good()) {
+    MUNTJAC_ERROR << "Unable to write statistics to " << filename << endl;
+    return;
+  }
+
+  double wall_time = wall.seconds();
+  double ports_time = harness.seconds() - eval.seconds();
+  double other_time = wall_time - harness.seconds() - trace.seconds();
+
+  file << std::fixed << std::setprecision(6);
+  file << "{\n";
+  file << "  \"program\": \"" << json_escape(program) << "\",\n";
+  file << "  \"exit_code\": " << exit_code << ",\n";
+  file << "  \"timed_out\": " << (timed_out ? "true" : "false") << ",\n";
+  file << "  \"cycles\": " << cycles << ",\n";
+  file << "  \"instructions\": " << instructions << ",\n";
+  file << "  \"wall_seconds\": " << wall_time << ",\n";
+  file << "  \"cycles_per_second\": " << rate(cycles, wall_time) << ",\n";
+  file << "  \"instructions_per_second\": " << rate(instructions, wall_time) << ",\n";
+  file << "  \"host_seconds\": {\n";
+  file << "    \"eval\": " << eval.seconds() << ",\n";
+  file << "    \"ports\": " << ports_time << ",\n";
+  file << "    \"tracing\": " << trace.seconds() << ",\n";
+  file << "    \"other\": " << other_time << "\n";
+  file << "  }\n";
+  file << "}\n";
+
+  file.close();
+}
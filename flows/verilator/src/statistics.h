@@ -0,0 +1,87 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Statistics describing how quickly the simulator itself runs on the host.
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+// Accumulate the host time spent in one part of the simulator. A timer may be
+// started and stopped many times; the total is the sum of all intervals.
+class HostTimer {
+public:
+
+  HostTimer();
+
+  // Defined here so they can be inlined into the simulation loop.
+  void start() {started = clock::now();}
+  void stop()  {total += clock::now() - started;}
+
+  void clear();
+
+  // Total time accumulated so far.
+  double seconds() const;
+
+private:
+
+  typedef std::chrono::steady_clock clock;
+
+  clock::time_point started;
+  clock::duration   total;
+
+};
+
+class SimulationStatistics {
+public:
+
+  SimulationStatistics();
+
+  // Clear all counters and timers.
+  void clear();
+
+  // Write all statistics to a JSON file.
+  void write_json(string filename) const;
+
+// Simulated behaviour.
+
+  // The program being executed.
+  string program;
+
+  // Clock cycles simulated.
+  uint64_t cycles;
+
+  // Instructions retired. Detected by changes in the debug PC, so consecutive
+  // executions of the same instruction are only counted once.
+  uint64_t instructions;
+
+  // Value returned by the simulated program.
+  int exit_code;
+
+  // Whether the simulation was stopped by the timeout.
+  bool timed_out;
+
+// Host behaviour.
+
+  // Complete simulation loop, excluding initialisation.
+  HostTimer wall;
+
+  // Verilator model evaluation.
+  HostTimer eval;
+
+  // All per-cycle harness work, including `eval`. Time spent in the memory
+  // ports is `harness - eval`.
+  HostTimer harness;
+
+  // VCD/FST/CSV tracing and logging.
+  HostTimer trace;
+
+};
+
+#endif  // STATISTICS_H
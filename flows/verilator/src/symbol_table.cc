@@ -0,0 +1,82 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <sstream>
+
+#include "logs.h"
+#include "symbol_table.h"
+
+using std::stringstream;
+
+void SymbolTable::clear() {
+  addresses.clear();
+  functions.clear();
+}
+
+void SymbolTable::reserve(size_t num_symbols) {
+  addresses.reserve(num_symbols);
+}
+
+void SymbolTable::add(const elf_symbol_t& symbol, bool function) {
+  addresses.emplace(symbol.name, symbol.address);
+
+  if (function)
+    functions.push_back(symbol);
+}
+
+void SymbolTable::sort() {
+  std::sort(functions.begin(), functions.end(),
+    [](const elf_symbol_t& a, const elf_symbol_t& b) {
+      return a.address < b.address;
+    }
+  );
+}
+
+MemoryAddress SymbolTable::location(const string& name) const {
+  auto it = addresses.find(name);
+
+  if (it == addresses.end()) {
+    MUNTJAC_WARN << "Couldn't find symbol \"" << name << "\" in ELF" << endl;
+    return -1;
+  }
+
+  return it->second;
+}
+
+const elf_symbol_t* SymbolTable::lookup(MemoryAddress address) const {
+  // Find the last function starting at or before this address.
+  auto it = std::upper_bound(functions.begin(), functions.end(), address,
+    [](MemoryAddress address, const elf_symbol_t& symbol) {
+      return address < symbol.address;
+    }
+  );
+
+  if (it == functions.begin())
+    return NULL;
+
+  --it;
+
+  // Symbols without a size extend to the next symbol.
+  if (it->size == 0 || address < it->address + it->size)
+    return &(*it);
+  else
+    return NULL;
+}
+
+string SymbolTable::function_name(MemoryAddress address) const {
+  const elf_symbol_t* symbol = lookup(address);
+  return (symbol == NULL) ? "[unknown]" : symbol->name;
+}
+
+string SymbolTable::describe(MemoryAddress address) const {
+  const elf_symbol_t* symbol = lookup(address);
+
+  if (symbol == NULL)
+    return "[unknown]";
+
+  stringstream ss;
+  ss << symbol->name << "+0x" << std::hex << (address - symbol->address);
+  return ss.str();
+}
@@ -0,0 +1,66 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Index of the symbols in a program: look up addresses by name, and map code
+// addresses back to the functions containing them.
+
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.h"
+
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+// A named region of an executable.
+typedef struct {
+  string        name;
+  MemoryAddress address;
+  uint64_t      size;  // May be 0 if the size is unknown.
+} elf_symbol_t;
+
+class SymbolTable {
+public:
+
+  // Remove all symbols.
+  void clear();
+
+  // Prepare for `num_symbols` calls to `add`.
+  void reserve(size_t num_symbols);
+
+  // Add a symbol. Only functions are used when describing code addresses. If
+  // multiple symbols share a name, the first one added is kept.
+  void add(const elf_symbol_t& symbol, bool function);
+
+  // Must be called after adding symbols and before describing addresses.
+  void sort();
+
+  // Get the memory address to which the named symbol is mapped, or -1 if there
+  // is no such symbol.
+  MemoryAddress location(const string& name) const;
+
+  // Name of the function containing `address`, or "[unknown]".
+  string function_name(MemoryAddress address) const;
+
+  // As above, with the offset into the function appended, e.g. "main+0x1c".
+  string describe(MemoryAddress address) const;
+
+private:
+
+  // The function containing `address`, or NULL.
+  const elf_symbol_t* lookup(MemoryAddress address) const;
+
+  unordered_map<string, MemoryAddress> addresses;
+
+  // Sorted by address.
+  vector<elf_symbol_t> functions;
+
+};
+
+#endif  // SYMBOL_TABLE_H
@@ -0,0 +1,308 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logs.h"
+#include "system_calls.h"
+
+// System call numbers from the RISC-V Linux ABI.
+#define SYS_openat        56
+#define SYS_close         57
+#define SYS_lseek         62
+#define SYS_read          63
+#define SYS_write         64
+#define SYS_fstat         80
+#define SYS_exit          93
+#define SYS_exit_group    94
+#define SYS_gettimeofday  169
+#define SYS_brk           214
+#define SYS_open          1024  // Used by older versions of newlib
+
+// Flags for open, as defined by the RISC-V Linux ABI.
+#define RV_O_ACCMODE      0x003
+#define RV_O_CREAT        0x040
+#define RV_O_EXCL         0x080
+#define RV_O_TRUNC        0x200
+#define RV_O_APPEND       0x400
+#define RV_AT_FDCWD       -100
+
+// Simulated time advances by 1ns per cycle.
+#define NS_PER_CYCLE      1
+
+// Largest host buffer used for read and write. Longer transfers are split, so
+// the program's requested length doesn't determine the simulator's memory use.
+#define MAX_TRANSFER      (1 << 16)
+
+SystemCallProxy::SystemCallProxy(MainMemory& memory) :
+    memory(memory) {
+  reset(0);
+}
+
+SystemCallProxy::~SystemCallProxy() {
+  close_files();
+}
+
+void SystemCallProxy::reset(MemoryAddress program_end) {
+  close_files();
+
+  // Standard input, output and error are shared with the simulator.
+  files = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+
+  initial_break = program_break = program_end;
+  has_exited = false;
+  exit_arg = 0;
+}
+
+bool SystemCallProxy::exited() const {
+  return has_exited;
+}
+
+int64_t SystemCallProxy::exit_argument() const {
+  return exit_arg;
+}
+
+void SystemCallProxy::execute(MemoryAddress address) {
+  uint64_t args[8];
+  for (int i=0; i<8; i++)
+    args[i] = memory.read64(address + i*8);
+
+  int64_t result;
+
+  switch (args[0]) {
+    case SYS_read:
+      result = sys_read(args[1], args[2], args[3]);
+      break;
+    case SYS_write:
+      result = sys_write(args[1], args[2], args[3]);
+      break;
+    case SYS_openat:
+      result = sys_openat(args[1], args[2], args[3], args[4]);
+      break;
+    case SYS_open:
+      result = sys_openat(RV_AT_FDCWD, args[1], args[2], args[3]);
+      break;
+    case SYS_close:
+      result = sys_close(args[1]);
+      break;
+    case SYS_lseek:
+      result = sys_lseek(args[1], args[2], args[3]);
+      break;
+    case SYS_fstat:
+      result = sys_fstat(args[1], args[2]);
+      break;
+    case SYS_gettimeofday:
+      result = sys_gettimeofday(args[1]);
+      break;
+    case SYS_brk:
+      result = sys_brk(args[1]);
+      break;
+    case SYS_exit:
+    case SYS_exit_group:
+      has_exited = true;
+      exit_arg = args[1];
+      result = 0;
+      break;
+    default:
+      MUNTJAC_WARN << "Unsupported system call " << args[0] << endl;
+      result = -ENOSYS;
+      break;
+  }
+
+  MUNTJAC_LOG(2) << "System call " << args[0] << " returned " << result << endl;
+
+  memory.write64(address, result);
+}
+
+void SystemCallProxy::close_files() {
+  for (int host : opened)
+    close(host);
+  opened.clear();
+}
+
+int SystemCallProxy::host_fd(int64_t fd) const {
+  if (fd < 0 || fd >= (int64_t)files.size())
+    return -1;
+  else
+    return files[fd];
+}
+
+string SystemCallProxy::read_string(MemoryAddress address) {
+  string result;
+
+  for (char c = memory.read8(address); c != '\0'; c = memory.read8(++address))
+    result += c;
+
+  return result;
+}
+
+int64_t SystemCallProxy::sys_read(int64_t fd, MemoryAddress buffer,
+                                  uint64_t length) {
+  int host = host_fd(fd);
+  if (host < 0)
+    return -EBADF;
+
+  vector<char> data(std::min<uint64_t>(length, MAX_TRANSFER));
+  uint64_t total = 0;
+
+  while (total < length) {
+    size_t chunk = std::min<uint64_t>(length - total, MAX_TRANSFER);
+    ssize_t bytes = read(host, data.data(), chunk);
+    if (bytes < 0)
+      return (total > 0) ? (int64_t)total : -errno;
+
+    memory.write(buffer + total, data.data(), bytes);
+    total += bytes;
+
+    // Stop at the end of the available data rather than blocking for more.
+    if ((size_t)bytes < chunk)
+      break;
+  }
+
+  return total;
+}
+
+int64_t SystemCallProxy::sys_write(int64_t fd, MemoryAddress buffer,
+                                   uint64_t length) {
+  int host = host_fd(fd);
+  if (host < 0)
+    return -EBADF;
+
+  if (host == STDERR_FILENO)
+    log_flush();
+
+  uint64_t total = 0;
+
+  while (total < length) {
+    size_t chunk = std::min<uint64_t>(length - total, MAX_TRANSFER);
+    DataBlock data = memory.read(buffer + total, chunk);
+
+    // Use stdio for the console so the output stays in order with the
+    // simulator's own (buffered) output.
+    ssize_t bytes;
+    if (host == STDOUT_FILENO)
+      bytes = fwrite(data.get_data().get(), 1, chunk, stdout);
+    else if (host == STDERR_FILENO)
+      bytes = fwrite(data.get_data().get(), 1, chunk, stderr);
+    else
+      bytes = write(host, data.get_data().get(), chunk);
+
+    if (bytes < 0)
+      return (total > 0) ? (int64_t)total : -errno;
+
+    total += bytes;
+    if ((size_t)bytes < chunk)
+      break;
+  }
+
+  return total;
+}
+
+int64_t SystemCallProxy::sys_openat(int64_t dirfd, MemoryAddress path,
+                                    int64_t flags, int64_t mode) {
+  // Only paths relative to the simulator's working directory are supported.
+  if (dirfd != RV_AT_FDCWD)
+    return -EBADF;
+
+  int host_flags = flags & RV_O_ACCMODE;
+  if (flags & RV_O_CREAT)  host_flags |= O_CREAT;
+  if (flags & RV_O_EXCL)   host_flags |= O_EXCL;
+  if (flags & RV_O_TRUNC)  host_flags |= O_TRUNC;
+  if (flags & RV_O_APPEND) host_flags |= O_APPEND;
+
+  string filename = read_string(path);
+  int host = open(filename.c_str(), host_flags, mode);
+  if (host < 0)
+    return -errno;
+
+  opened.insert(host);
+
+  // Reuse the lowest free descriptor, as a kernel would.
+  for (size_t fd=0; fd<files.size(); fd++) {
+    if (files[fd] < 0) {
+      files[fd] = host;
+      return fd;
+    }
+  }
+
+  files.push_back(host);
+  return files.size() - 1;
+}
+
+int64_t SystemCallProxy::sys_close(int64_t fd) {
+  int host = host_fd(fd);
+  if (host < 0)
+    return -EBADF;
+
+  // Don't close the simulator's own standard streams.
+  if (opened.erase(host))
+    close(host);
+
+  files[fd] = -1;
+  return 0;
+}
+
+int64_t SystemCallProxy::sys_lseek(int64_t fd, int64_t offset,
+                                   int64_t whence) {
+  int host = host_fd(fd);
+  if (host < 0)
+    return -EBADF;
+
+  off_t position = lseek(host, offset, whence);
+  return (position < 0) ? -errno : position;
+}
+
+int64_t SystemCallProxy::sys_fstat(int64_t fd, MemoryAddress stat_buffer) {
+  int host = host_fd(fd);
+  if (host < 0)
+    return -EBADF;
+
+  struct stat info;
+  if (fstat(host, &info) != 0)
+    return -errno;
+
+  // Layout of `struct stat` for 64-bit RISC-V.
+  char data[128] = {0};
+  *(uint64_t*)(data +   0) = info.st_dev;
+  *(uint64_t*)(data +   8) = info.st_ino;
+  *(uint32_t*)(data +  16) = info.st_mode;
+  *(uint32_t*)(data +  20) = info.st_nlink;
+  *(uint32_t*)(data +  24) = info.st_uid;
+  *(uint32_t*)(data +  28) = info.st_gid;
+  *(uint64_t*)(data +  32) = info.st_rdev;
+  *(int64_t*) (data +  48) = info.st_size;
+  *(int32_t*) (data +  56) = info.st_blksize;
+  *(int64_t*) (data +  64) = info.st_blocks;
+  *(int64_t*) (data +  72) = info.st_atim.tv_sec;
+  *(uint64_t*)(data +  80) = info.st_atim.tv_nsec;
+  *(int64_t*) (data +  88) = info.st_mtim.tv_sec;
+  *(uint64_t*)(data +  96) = info.st_mtim.tv_nsec;
+  *(int64_t*) (data + 104) = info.st_ctim.tv_sec;
+  *(uint64_t*)(data + 112) = info.st_ctim.tv_nsec;
+
+  memory.write(stat_buffer, data, sizeof(data));
+  return 0;
+}
+
+int64_t SystemCallProxy::sys_gettimeofday(MemoryAddress timeval) {
+  // Report simulated time so measurements within the program are repeatable.
+  uint64_t ns = (uint64_t)sc_time_stamp() * NS_PER_CYCLE;
+
+  memory.write64(timeval + 0, ns / 1000000000);
+  memory.write64(timeval + 8, (ns / 1000) % 1000000);
+  return 0;
+}
+
+int64_t SystemCallProxy::sys_brk(MemoryAddress address) {
+  // Memory is allocated on demand, so any break above the program is valid.
+  if (address >= initial_break)
+    program_break = address;
+
+  return program_break;
+}
@@ -0,0 +1,84 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Host-side proxy for system calls made through the HTIF `tohost`/`fromhost`
+// interface, as used by riscv-pk and libgloss-htif.
+//
+// The program writes a pointer to a block of 8 doublewords to `tohost`. The
+// block holds the system call number followed by its arguments. The proxy
+// performs the call on the host, writes the result to the first doubleword,
+// then writes 1 to `fromhost`.
+//
+// Buffers are accessed directly in main memory, so the proxy is only usable
+// when the model has no data cache which could hold newer data.
+
+#ifndef SYSTEM_CALLS_H
+#define SYSTEM_CALLS_H
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "main_memory.h"
+#include "types.h"
+
+using std::string;
+using std::vector;
+
+class SystemCallProxy {
+public:
+
+  SystemCallProxy(MainMemory& memory);
+  ~SystemCallProxy();
+
+  // Prepare for a new program. `program_end` is the first address after the
+  // program's data, where the heap starts.
+  void reset(MemoryAddress program_end);
+
+  // Perform the system call described by the block of memory at `address`.
+  void execute(MemoryAddress address);
+
+  // Whether the program has called exit, and the argument it gave.
+  bool exited() const;
+  int64_t exit_argument() const;
+
+private:
+
+  int64_t sys_read(int64_t fd, MemoryAddress buffer, uint64_t length);
+  int64_t sys_write(int64_t fd, MemoryAddress buffer, uint64_t length);
+  int64_t sys_openat(int64_t dirfd, MemoryAddress path, int64_t flags,
+                     int64_t mode);
+  int64_t sys_close(int64_t fd);
+  int64_t sys_lseek(int64_t fd, int64_t offset, int64_t whence);
+  int64_t sys_fstat(int64_t fd, MemoryAddress stat_buffer);
+  int64_t sys_gettimeofday(MemoryAddress timeval);
+  int64_t sys_brk(MemoryAddress address);
+
+  // Host file descriptor for a program's file descriptor, or -1.
+  int host_fd(int64_t fd) const;
+
+  string read_string(MemoryAddress address);
+
+  // Close every host file opened on the program's behalf.
+  void close_files();
+
+  MainMemory& memory;
+
+  // Host file descriptors, indexed by the program's file descriptors.
+  vector<int> files;
+
+  // Host file descriptors opened by the proxy, which it must close. These may
+  // occupy any program descriptor, including 0-2 once they have been closed.
+  std::set<int> opened;
+
+  MemoryAddress program_break;
+  MemoryAddress initial_break;
+
+  bool has_exited;
+  int64_t exit_arg;
+
+};
+
+#endif  // SYSTEM_CALLS_H
@@ -0,0 +1,129 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "uart.h"
+
+// Register indices.
+#define UART_RBR 0  // Receive buffer (read)
+#define UART_THR 0  // Transmit holding (write)
+#define UART_IER 1
+#define UART_IIR 2  // Interrupt identification (read)
+#define UART_FCR 2  // FIFO control (write)
+#define UART_LCR 3
+#define UART_MCR 4
+#define UART_LSR 5
+#define UART_MSR 6
+#define UART_SCR 7
+
+#define IER_RX_DATA   0x01
+#define IER_TX_EMPTY  0x02
+
+#define IIR_NONE      0x01
+#define IIR_TX_EMPTY  0x02
+#define IIR_RX_DATA   0x04
+#define IIR_FIFO      0xc0
+
+#define LCR_DLAB      0x80
+
+#define LSR_DR        0x01  // Data ready
+#define LSR_THRE      0x20  // Transmit holding register empty
+#define LSR_TEMT      0x40  // Transmitter empty
+
+#define MSR_CONNECTED 0xb0  // DCD, DSR, CTS
+
+Uart16550::Uart16550(Console& console) :
+    MemoryMappedDevice(DEFAULT_ADDRESS, 8),
+    console(console) {
+  reset();
+}
+
+void Uart16550::reset() {
+  ier = 0;
+  lcr = 0x03;  // 8 data bits
+  mcr = 0;
+  scr = 0;
+  dll = 1;
+  dlm = 0;
+  fifo_enabled = false;
+  thre_pending = false;
+
+  // Each program sees the whole of the scripted input.
+  console.rewind_input();
+}
+
+uint64_t Uart16550::read(MemoryAddress offset, int /*num_bytes*/) {
+  bool dlab = lcr & LCR_DLAB;
+
+  switch (offset) {
+    case UART_RBR: return dlab ? dll : (uint8_t)console.get();
+    case UART_IER: return dlab ? dlm : ier;
+    case UART_IIR: {
+      // Reporting a THRE interrupt acknowledges it.
+      uint8_t iir = interrupt_identification();
+      if ((iir & 0x0f) == IIR_TX_EMPTY)
+        thre_pending = false;
+      return iir;
+    }
+    case UART_LCR: return lcr;
+    case UART_MCR: return mcr;
+    case UART_LSR: return LSR_THRE | LSR_TEMT |
+                          (console.has_input() ? LSR_DR : 0);
+    case UART_MSR: return MSR_CONNECTED;
+    case UART_SCR: return scr;
+    default:       return 0;
+  }
+}
+
+void Uart16550::write(MemoryAddress offset, uint64_t data,
+                      int /*num_bytes*/) {
+  bool dlab = lcr & LCR_DLAB;
+
+  switch (offset) {
+    case UART_THR:
+      if (dlab)
+        dll = data;
+      else {
+        // Writing THR acknowledges THRE, but transmission is instantaneous,
+        // so the register is empty again and raises a new interrupt.
+        console.put(data);
+        thre_pending = true;
+      }
+      break;
+    case UART_IER:
+      if (dlab)
+        dlm = data;
+      else
+        set_ier(data);
+      break;
+    case UART_FCR: fifo_enabled = data & 0x01; break;
+    case UART_LCR: lcr = data; break;
+    case UART_MCR: mcr = data; break;
+    case UART_SCR: scr = data; break;
+    default: break;  // LSR and MSR are read-only.
+  }
+}
+
+void Uart16550::set_ier(uint8_t value) {
+  // The transmitter is always empty, so enabling its interrupt raises one.
+  if ((value & IER_TX_EMPTY) && !(ier & IER_TX_EMPTY))
+    thre_pending = true;
+
+  ier = value & 0x0f;
+}
+
+uint8_t Uart16550::interrupt_identification() const {
+  uint8_t fifo = fifo_enabled ? IIR_FIFO : 0;
+
+  // Received data has priority over transmitter empty.
+  if ((ier & IER_RX_DATA) && console.has_input())
+    return fifo | IIR_RX_DATA;
+  else if ((ier & IER_TX_EMPTY) && thre_pending)
+    return fifo | IIR_TX_EMPTY;
+  else
+    return fifo | IIR_NONE;
+}
+
+bool Uart16550::interrupt_pending() const {
+  return (interrupt_identification() & IIR_NONE) == 0;
+}
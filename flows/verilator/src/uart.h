@@ -0,0 +1,55 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// 16550-compatible UART, connected to the simulator's console.
+//
+// Registers are one byte apart, as in QEMU's `virt` machine, so software
+// written for an "ns16550a" with reg-shift = 0 and reg-io-width = 1 (e.g.
+// OpenSBI and Linux) works unchanged. Transmission is instantaneous, and
+// input is always ready if any is available.
+
+#ifndef UART_H
+#define UART_H
+
+#include "console.h"
+#include "memory_mapped_device.h"
+
+class Uart16550 : public MemoryMappedDevice {
+public:
+
+  static const MemoryAddress DEFAULT_ADDRESS = 0x10000000;
+
+  Uart16550(Console& console);
+
+  virtual uint64_t read(MemoryAddress offset, int num_bytes);
+  virtual void write(MemoryAddress offset, uint64_t data, int num_bytes);
+  virtual void reset();
+
+  // The UART is requesting an interrupt.
+  bool interrupt_pending() const;
+
+private:
+
+  uint8_t interrupt_identification() const;
+
+  // Write the interrupt enable register.
+  void set_ier(uint8_t value);
+
+  Console& console;
+
+  uint8_t ier;  // Interrupt enable
+  uint8_t lcr;  // Line control
+  uint8_t mcr;  // Modem control
+  uint8_t scr;  // Scratch
+  uint8_t dll;  // Divisor latch (low)
+  uint8_t dlm;  // Divisor latch (high)
+  bool fifo_enabled;
+
+  // A transmitter holding register empty interrupt is waiting to be
+  // acknowledged, by reading IIR or writing THR.
+  bool thre_pending;
+
+};
+
+#endif  // UART_H
@@ -42,9 +42,13 @@ module muntjac_core import muntjac_pkg::*; #(
     input  logic [63:0] hart_id_i,
 
     input  logic [HPM_EVENT_NUM-1:0] hpm_event_i,
+    // All events, including those generated inside the core.
+    output logic [HPM_EVENT_NUM-1:0] hpm_event_o,
 
     // Debug connections
-    output instr_trace_t dbg_o
+    output instr_trace_t dbg_o,
+    output branch_trace_t dbg_branch_o,
+    output trap_trace_t dbg_trap_o
 );
 
   `TL_DECLARE(DataWidth, PhysAddrLen, SourceWidth, SinkWidth, mem);
@@ -98,7 +102,10 @@ module muntjac_core import muntjac_pkg::*; #(
       .irq_external_s_i,
       .hart_id_i,
       .hpm_event_i (hpm_event),
-      .dbg_o
+      .hpm_event_o,
+      .dbg_o,
+      .dbg_branch_o,
+      .dbg_trap_o
   );
 
   `TL_DECLARE_ARR(DataWidth, PhysAddrLen, SourceWidth, SinkWidth, ch, [1:0]);
@@ -39,9 +39,13 @@ module muntjac_backend import muntjac_pkg::*; #(
     input  logic [63:0] hart_id_i,
 
     input  logic [HPM_EVENT_NUM-1:0] hpm_event_i,
+    // All events, including those generated by the pipeline.
+    output logic [HPM_EVENT_NUM-1:0] hpm_event_o,
 
     // Debug connections
-    output instr_trace_t  dbg_o
+    output instr_trace_t  dbg_o,
+    output branch_trace_t dbg_branch_o,
+    output trap_trace_t   dbg_trap_o
 );
 
   // Number of bits required to recover a legal full 64-bit address.
@@ -1157,7 +1161,7 @@ module muntjac_backend import muntjac_pkg::*; #(
     .make_fs_dirty_i (make_fs_dirty),
     .set_fflags_i (ex2_pending_q && ex2_data_valid ? ex2_fflags : '0),
     .instr_ret_i (ex2_pending_q && ex2_data_valid),
-    .hpm_event_i
+    .hpm_event_i (hpm_event_o)
   );
 
   always_comb begin
@@ -1195,6 +1199,44 @@ module muntjac_backend import muntjac_pkg::*; #(
     end
   end
 
+  //////////////////////////////////
+  // Performance Monitoring Events //
+  //////////////////////////////////
+
+  // The cycle where a mispredicted instruction reaches EX. It is discarded
+  // rather than issued.
+  wire ex_mispredict = ex_state_q == ST_NORMAL && de_ex_valid && ex_expected_pc_q != de_ex_decoded.pc;
+
+  // Each cycle where no instruction issues is attributed to exactly one of
+  // MISPREDICT_STALL, FRONTEND_STALL or BACKEND_STALL.
+  always_comb begin
+    hpm_event_o = hpm_event_i;
+    hpm_event_o[HPM_EVENT_BRANCH_MISPREDICT] = ex_mispredict;
+    hpm_event_o[HPM_EVENT_MISPREDICT_STALL] = ex_state_q == ST_MISPREDICT || ex_mispredict;
+    hpm_event_o[HPM_EVENT_FRONTEND_STALL] =
+        (ex_state_q == ST_NORMAL || ex_state_q == ST_FLUSH) && !de_ex_valid;
+    hpm_event_o[HPM_EVENT_BACKEND_STALL] =
+        (ex_state_q != ST_MISPREDICT && de_ex_valid && !ex_issue && !ex_mispredict) ||
+        ((ex_state_q == ST_INT || ex_state_q == ST_SYS) && !de_ex_valid);
+    hpm_event_o[HPM_EVENT_DIV_BUSY] = !div_ready;
+    hpm_event_o[HPM_EVENT_FPU_BUSY] = !fpu_ready;
+  end
+
+  always_comb begin
+    dbg_branch_o.resolved = ex_branch_type_q != BRANCH_NONE;
+    dbg_branch_o.branch_type = ex_branch_type_q;
+    dbg_branch_o.pc = 64'(signed'(ex1_pc_q));
+    dbg_branch_o.target = ex_expected_pc_q;
+    dbg_branch_o.mispredict = hpm_event_o[HPM_EVENT_BRANCH_MISPREDICT];
+    dbg_branch_o.predicted = de_ex_decoded.if_reason ==? IF_PREDICT;
+  end
+
+  always_comb begin
+    dbg_trap_o.valid = mem_trap_valid || exception_issue;
+    dbg_trap_o.cause = mem_trap_valid ? mem_trap.cause : de_ex_decoded.exception.cause;
+    dbg_trap_o.tvec = exc_tvec_d;
+  end
+
   always_ff @(posedge clk_i) begin
     if (mem_trap_valid || exception_issue) begin
       $display("%t: trap %x", $time, mem_trap_valid ? 64'(signed'(ex2_pc_q)) : de_ex_decoded.pc);
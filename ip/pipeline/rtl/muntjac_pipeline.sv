@@ -24,9 +24,12 @@ module muntjac_pipeline import muntjac_pkg::*; #(
     input  logic [63:0] hart_id_i,
 
     input  logic [HPM_EVENT_NUM-1:0] hpm_event_i,
+    output logic [HPM_EVENT_NUM-1:0] hpm_event_o,
 
     // Debug connections
-    output instr_trace_t dbg_o
+    output instr_trace_t dbg_o,
+    output branch_trace_t dbg_branch_o,
+    output trap_trace_t dbg_trap_o
 );
 
   logic [63:0]     satp;
@@ -84,7 +87,10 @@ module muntjac_pipeline import muntjac_pkg::*; #(
       .irq_external_s_i,
       .hart_id_i,
       .hpm_event_i,
-      .dbg_o
+      .hpm_event_o,
+      .dbg_o,
+      .dbg_branch_o,
+      .dbg_trap_o
   );
 
 endmodule
@@ -337,10 +337,16 @@ typedef enum logic [3:0] {
   HPM_EVENT_L1_DTLB_MISS = 6,
   HPM_EVENT_L2_ACQ_COUNT = 7,
   HPM_EVENT_L2_REL_COUNT = 8,
-  HPM_EVENT_L2_MISS = 9
+  HPM_EVENT_L2_MISS = 9,
+  HPM_EVENT_BRANCH_MISPREDICT = 10,
+  HPM_EVENT_MISPREDICT_STALL = 11,
+  HPM_EVENT_FRONTEND_STALL = 12,
+  HPM_EVENT_BACKEND_STALL = 13,
+  HPM_EVENT_DIV_BUSY = 14,
+  HPM_EVENT_FPU_BUSY = 15
 } hpm_event_e;
 
-parameter int unsigned HPM_EVENT_NUM = 10;
+parameter int unsigned HPM_EVENT_NUM = 16;
 
 ////////////////////
 // Virtual memory //
@@ -541,6 +547,35 @@ typedef struct packed {
 `endif
 } instr_trace_t;
 
+// Branch prediction information, for measuring predictor accuracy.
+typedef struct packed {
+  // A jump or branch was resolved this cycle. `branch_type` also encodes
+  // whether a branch was taken.
+  logic         resolved;
+  branch_type_e branch_type;
+
+  // PC of the most recently issued instruction, and the PC which should follow
+  // it.
+  logic [63:0]  pc;
+  logic [63:0]  target;
+
+  // The instruction following `pc` was fetched from the wrong address.
+  logic         mispredict;
+  // The wrong instruction was fetched from a predicted target (BTB or RAS),
+  // rather than sequentially.
+  logic         predicted;
+} branch_trace_t;
+
+// Trap information, for measuring interrupt latency.
+typedef struct packed {
+  // A trap was taken this cycle.
+  logic        valid;
+  exc_cause_e  cause;
+
+  // Address of the trap handler.
+  logic [63:0] tvec;
+} trap_trace_t;
+
 typedef struct packed {
   logic [4:0]  rs1;
   logic [4:0]  rs2;
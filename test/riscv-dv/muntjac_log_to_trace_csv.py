@@ -3,6 +3,11 @@
 # SPDX-License-Identifier: Apache-2.0
 
 """
+The simulator's `--csv` option now writes complete riscv-dv rows, decoding
+instructions itself, so this script is only needed as a fallback: for traces
+from older simulators, or to decode instructions which the simulator reports as
+"unknown".
+
 Convert the output of muntjac's `--csv` option to the required CSV format for
 riscv-dv. The output is already a CSV, but some changes need to be made:
  * Decode the instruction binary to get
@@ -335,6 +340,14 @@ riscv_dv_fields = [
 def translate_row(row, fast=False):
     """Translate a single row of data from Muntjac simulator format to riscv-dv
     format."""
+    # Rows which are already in riscv-dv format only need instructions decoding
+    # if the simulator couldn't.
+    if "instr" in row:
+        new_row = OrderedDict((field, row.get(field, "")) for field in riscv_dv_fields)
+        if not fast and row["instr"] == "unknown":
+            new_row.update(decode_row(row))
+        return new_row
+
     new_row = OrderedDict()
 
     new_row["pc"] = row["pc"]       # TODO: zero pad?
@@ -350,22 +363,29 @@ def translate_row(row, fast=False):
     # Decode instructions to output more information. Doing this slows down the
     # script by 20x.
     if not fast:
-        try:
-            # The `decode` function supports a `variant` argument specifying the
-            # allowed instruction set extensions, but at the time of writing, it
-            # makes the output worse.
-            decoded = str(decode(int(row["binary"], 16)))
-            parts = decoded.split(maxsplit=1)
-            new_row["instr"] = parts[0]
-            new_row["instr_str"] = decoded
-            new_row["operand"] = parts[1] if len(parts) > 1 else ""
-        except MachineDecodeError:
-            # riscvmodel isn't yet able to decode all instructions, but this
-            # doesn't matter for trace comparisons.
-            pass
+        new_row.update(decode_row(row))
 
     return new_row
 
+def decode_row(row):
+    """Decode a row's instruction binary, returning the instr, instr_str and
+    operand fields, or nothing if the instruction can't be decoded."""
+    try:
+        # The `decode` function supports a `variant` argument specifying the
+        # allowed instruction set extensions, but at the time of writing, it
+        # makes the output worse.
+        decoded = str(decode(int(row["binary"], 16)))
+        parts = decoded.split(maxsplit=1)
+        return {
+            "instr": parts[0],
+            "instr_str": decoded,
+            "operand": parts[1] if len(parts) > 1 else ""
+        }
+    except MachineDecodeError:
+        # riscvmodel isn't yet able to decode all instructions, but this
+        # doesn't matter for trace comparisons.
+        return {}
+
 def main():
     parser = argparse.ArgumentParser(description="RISCV-DV trace translation script")
     parser.add_argument("--log", type=str, required=True,
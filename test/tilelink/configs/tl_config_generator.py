@@ -118,6 +118,23 @@ def get_routing_table(config, id_name, endpoint_type):
         return RoutingTable(num_ids, [], [], [])      
 
 
+# Random traffic parameters, passed through to the C++ configuration if present.
+# All can be prefixed with Host or Device, e.g. HostInjectionRate.
+TRAFFIC_PARAMETERS = ["InjectionRate", "SizeWeights", "OpcodeWeights",
+                      "AddressPattern", "AddressStride", "HotspotSize",
+                      "HotspotRate", "StallRate", "Backpressure"]
+
+
+def add_traffic_profile(endpoint_dict, config, endpoint_type):
+    for name in TRAFFIC_PARAMETERS:
+        value = get_parameter(config, name, endpoint_type, None)
+        if value is None:
+            continue
+        if isinstance(value, list):
+            value = " ".join(str(x) for x in value)
+        endpoint_dict[name] = value
+
+
 def write_cpp_config(filename, config):
     cpp_config = {}
 
@@ -150,6 +167,8 @@ def write_cpp_config(filename, config):
             host_dict["SinkMask"] = " ".join(str(x) for x in host_sink_table.masks)
             host_dict["SinkTarget"] = " ".join(str(x) for x in host_sink_table.links)
 
+        add_traffic_profile(host_dict, config, "Host")
+
         hosts.append(host_dict)
     cpp_config["hosts"] = hosts
 
@@ -173,6 +192,8 @@ def write_cpp_config(filename, config):
             device_dict["SourceMask"] = " ".join(str(x) for x in device_source_table.masks)
             device_dict["SourceTarget"] = " ".join(str(x) for x in device_source_table.links)
 
+        add_traffic_profile(device_dict, config, "Device")
+
         devices.append(device_dict)
     cpp_config["devices"] = devices
 
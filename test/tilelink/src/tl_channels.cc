@@ -12,15 +12,35 @@ extern TileLinkSimulation* the_sim;
 // Round `address` down so it is a multiple of `unit`.
 extern uint64_t align(uint64_t address, uint64_t unit);
 
+// Replay bookkeeping: see tl_replay_state_t.
+static bool replay_in_flight(const TileLinkEndpoint& endpoint, int channel,
+                             uint64_t id) {
+  return endpoint.replay.in_flight.count(replay_key(channel, id)) > 0;
+}
+
+static bool replay_has_received(const TileLinkEndpoint& endpoint, int channel,
+                                uint64_t id) {
+  return endpoint.replay.received.count(replay_key(channel, id)) > 0;
+}
+
+// Use up one received message, now that its response has been sent.
+static void replay_consume(TileLinkEndpoint& endpoint, int channel,
+                           uint64_t id) {
+  auto message = endpoint.replay.received.find(replay_key(channel, id));
+  if (message != endpoint.replay.received.end())
+    endpoint.replay.received.erase(message);
+}
+
 
 ///////////////
 // Channel A //
 ///////////////
 
+extern bool has_payload(tl_a_op_e opcode);
 extern bool requires_response(tl_a_op_e opcode);
 
 void TileLinkSenderA::queue_request(bool randomise, 
-                                    map<string, int> requirements) {
+                                    const tl_modification& requirements) {
   if (!this->can_start_new_transaction())
     return;
 
@@ -34,13 +54,65 @@ void TileLinkSenderA::respond() {
   // Do nothing: the A channel doesn't respond to any others.
 }
 
+void TileLinkSenderA::delivered(const tl_message<tl_a>& message,
+                                const tl_a& beat) {
+  if (message.current_beat() == 1) {
+    this->parent.performance.request_started(channel_index<tl_a>(),
+                                             message.header.source);
+    this->parent.coverage.request_sent(message.header);
+    the_sim->scoreboard.request_sent(this->position(), beat.source,
+                                     beat.address);
+  }
+
+  if (has_payload(beat.opcode))
+    the_sim->scoreboard.sent(this->payload, TO_DEVICE, this->position(),
+                             beat.address, beat.size, this->bit_width() / 8,
+                             message.current_beat() - 1, beat.data, beat.mask,
+                             false);
+}
+
+bool TileLinkSenderA::replay_can_send(const tl_a& beat) const {
+  return !replay_in_flight(this->parent, channel_index<tl_a>(), beat.source);
+}
+
+void TileLinkSenderA::replay_sent(const tl_a& beat, bool first) {
+  if (first) {
+    this->parent.replay.in_flight.insert(replay_key(channel_index<tl_a>(),
+                                                    beat.source));
+    this->parent.performance.request_started(channel_index<tl_a>(),
+                                             beat.source);
+  }
+}
+
+void TileLinkReceiverA::replay_received(const tl_a& beat) {
+  if (has_payload(beat.opcode)) {
+    this->new_beat_arrived(beat.size);
+    if (!this->all_beats_arrived())
+      return;
+  }
+
+  this->parent.replay.received.insert(replay_key(channel_index<tl_a>(),
+                                                 beat.source));
+}
+
 void TileLinkReceiverA::handle_beat(bool randomise, tl_a data) {
   TileLinkDevice& device = static_cast<TileLinkDevice&>(this->parent);
 
+  int width_bytes = this->bit_width() / 8;
+  int host = this->routing_table().get_owner(data.source);
+
   switch (data.opcode) {
     case PutFullData:
     case PutPartialData:
       this->new_beat_arrived(data.size);
+      the_sim->scoreboard.memory(this->position()).write(
+          data.address, data.size, this->beat_index(data.size), width_bytes,
+          data.data, data.mask);
+      the_sim->scoreboard.received(this->payload, TO_DEVICE, host,
+                                   data.address, data.size, width_bytes,
+                                   this->beat_index(data.size), data.data,
+                                   data.mask, false);
+
       // Create response only when full message has arrived.
       if (this->all_beats_arrived())
         device.d.handle_request(randomise, data);
@@ -48,6 +120,15 @@ void TileLinkReceiverA::handle_beat(bool randomise, tl_a data) {
     
     case ArithmeticData:
     case LogicalData:
+      // The reference memory is updated when the response is generated.
+      this->new_beat_arrived(data.size);
+      the_sim->scoreboard.received(this->payload, TO_DEVICE, host,
+                                   data.address, data.size, width_bytes,
+                                   this->beat_index(data.size), data.data,
+                                   data.mask, false);
+      device.d.handle_request(randomise, data);
+      break;
+
     case Get:
     case Intent:
       device.d.handle_request(randomise, data);
@@ -123,7 +204,7 @@ void TileLinkSenderB::respond() {
 }
 
 void TileLinkSenderB::queue_request(bool randomise, 
-                                    map<string, int> requirements) {
+                                    const tl_modification& requirements) {
   // Only TL_C uses the B channel.
   if (this->protocol() != TL_C || !this->can_start_new_transaction())
     return;
@@ -161,6 +242,23 @@ void TileLinkSenderB::queue_request(bool randomise,
   }
 }
 
+bool TileLinkSenderB::replay_can_send(const tl_b& beat) const {
+  auto& device = static_cast<const TileLinkDevice&>(this->parent);
+  return !replay_in_flight(this->parent, channel_index<tl_b>(),
+                           device.get_b_id(beat.source, beat.address));
+}
+
+void TileLinkSenderB::replay_sent(const tl_b& beat, bool /*first*/) {
+  auto& device = static_cast<const TileLinkDevice&>(this->parent);
+  this->parent.replay.in_flight.insert(replay_key(channel_index<tl_b>(),
+      device.get_b_id(beat.source, beat.address)));
+}
+
+void TileLinkReceiverB::replay_received(const tl_b& beat) {
+  this->parent.replay.received.insert(replay_key(channel_index<tl_b>(),
+      align(beat.address, 1 << beat.size)));
+}
+
 void TileLinkReceiverB::handle_beat(bool randomise, tl_b data) {
   TileLinkHost& host = static_cast<TileLinkHost&>(this->parent);
 
@@ -183,6 +281,7 @@ void TileLinkReceiverB::handle_beat(bool randomise, tl_b data) {
 // Channel C //
 ///////////////
 
+extern bool has_payload(tl_c_op_e opcode);
 extern bool requires_response(tl_c_op_e opcode);
 
 void TileLinkSenderC::respond(bool randomise, tl_b& request) {
@@ -219,7 +318,7 @@ void TileLinkSenderC::respond() {
 }
 
 void TileLinkSenderC::queue_request(bool randomise, 
-                                    map<string, int> requirements) {
+                                    const tl_modification& requirements) {
   if ((this->protocol() != TL_C && this->protocol() != TL_C_ROM_TERM) ||
       !this->can_start_new_transaction())
     return;
@@ -231,11 +330,96 @@ void TileLinkSenderC::queue_request(bool randomise,
     this->start_transaction(request.header.source);
 }
 
+void TileLinkSenderC::delivered(const tl_message<tl_c>& message,
+                                const tl_c& beat) {
+  if (message.current_beat() == 1 && requires_response(message.header.opcode))
+    this->parent.performance.request_started(channel_index<tl_c>(),
+                                             message.header.source);
+
+  if (has_payload(beat.opcode))
+    the_sim->scoreboard.sent(this->payload, TO_DEVICE, this->position(),
+                             beat.address, beat.size, this->bit_width() / 8,
+                             message.current_beat() - 1, beat.data, ~0ULL,
+                             false);
+}
+
+bool TileLinkSenderC::replay_can_send(const tl_c& beat) const {
+  switch (beat.opcode) {
+    case ProbeAck:
+    case ProbeAckData:
+      return replay_has_received(this->parent, channel_index<tl_b>(),
+                                 align(beat.address, 1 << beat.size));
+
+    default:
+      return !replay_in_flight(this->parent, channel_index<tl_c>(),
+                               beat.source);
+  }
+}
+
+void TileLinkSenderC::replay_sent(const tl_c& beat, bool first) {
+  if (!first)
+    return;
+
+  switch (beat.opcode) {
+    case ProbeAck:
+    case ProbeAckData:
+      replay_consume(this->parent, channel_index<tl_b>(),
+                     align(beat.address, 1 << beat.size));
+      break;
+
+    default:
+      this->parent.replay.in_flight.insert(replay_key(channel_index<tl_c>(),
+                                                      beat.source));
+      this->parent.performance.request_started(channel_index<tl_c>(),
+                                               beat.source);
+      break;
+  }
+}
+
+void TileLinkReceiverC::replay_received(const tl_c& beat) {
+  TileLinkDevice& device = static_cast<TileLinkDevice&>(this->parent);
+
+  if (has_payload(beat.opcode)) {
+    this->new_beat_arrived(beat.size);
+    if (!this->all_beats_arrived())
+      return;
+  }
+
+  switch (beat.opcode) {
+    case ProbeAck:
+    case ProbeAckData: {
+      uint64_t address = align(beat.address, 1 << beat.size);
+      device.replay.in_flight.erase(replay_key(channel_index<tl_b>(),
+          device.get_b_id(beat.source, address)));
+      break;
+    }
+
+    default:
+      device.replay.received.insert(replay_key(channel_index<tl_c>(),
+                                               beat.source));
+      break;
+  }
+}
+
 void TileLinkReceiverC::handle_beat(bool randomise, tl_c data) {
   assert(this->protocol() == TL_C);
 
   TileLinkDevice& device = static_cast<TileLinkDevice&>(this->parent);
 
+  if (has_payload(data.opcode)) {
+    this->new_beat_arrived(data.size);
+
+    int width_bytes = this->bit_width() / 8;
+    the_sim->scoreboard.memory(this->position()).write(
+        data.address, data.size, this->beat_index(data.size), width_bytes,
+        data.data, ~0ULL);
+    int host = this->routing_table().get_owner(data.source);
+    the_sim->scoreboard.received(this->payload, TO_DEVICE, host,
+                                 data.address, data.size, width_bytes,
+                                 this->beat_index(data.size), data.data,
+                                 ~0ULL, false);
+  }
+
   // We don't support forwarding C responses to channel D, so few opcodes are
   // allowed.
   switch (data.opcode) {
@@ -244,7 +428,6 @@ void TileLinkReceiverC::handle_beat(bool randomise, tl_c data) {
       break;
 
     case ProbeAckData:
-      this->new_beat_arrived(data.size);
       if (this->all_beats_arrived()) {
         uint64_t first_beat_addr = align(data.address, 1 << data.size);
         device.b.end_transaction(device.get_b_id(data.source, first_beat_addr));
@@ -256,7 +439,6 @@ void TileLinkReceiverC::handle_beat(bool randomise, tl_c data) {
       break;
 
     case ReleaseData:
-      this->new_beat_arrived(data.size);
       // Create response only when full message has arrived.
       if (this->all_beats_arrived())
         device.d.handle_request(randomise, data);
@@ -269,6 +451,7 @@ void TileLinkReceiverC::handle_beat(bool randomise, tl_c data) {
 // Channel D //
 ///////////////
 
+extern bool has_payload(tl_d_op_e opcode);
 extern bool requires_response(tl_d_op_e opcode);
 
 void TileLinkSenderD::respond(bool randomise, tl_a& request) {
@@ -278,8 +461,16 @@ void TileLinkSenderD::respond(bool randomise, tl_a& request) {
   // each request beat.
   if (request.opcode == ArithmeticData || request.opcode == LogicalData) {
     if (!this->to_send.empty() && !this->to_send.back().complete()) {
-      this->to_send.back().new_beat_ready();
-      lock_output_buffer = !this->to_send.back().complete();
+      tl_message<tl_d>& response = this->to_send.back();
+
+      if (!response.payload.empty()) {
+        auto& memory = the_sim->scoreboard.memory(this->position());
+        response.payload.push_back(memory.atomic(request, response.payload.size(),
+                                                 this->bit_width() / 8));
+      }
+
+      response.new_beat_ready();
+      lock_output_buffer = !response.complete();
       return;
     }
   }
@@ -357,35 +548,130 @@ void TileLinkSenderD::respond() {
   }
 }
 
+void TileLinkSenderD::delivered(const tl_message<tl_d>& message,
+                                const tl_d& beat) {
+  // Denied responses carry no meaningful data.
+  if (has_payload(beat.opcode))
+    the_sim->scoreboard.sent(this->payload, TO_HOST,
+                             this->routing_table().get_owner(beat.source),
+                             message.request_address, beat.size,
+                             this->bit_width() / 8, message.current_beat() - 1,
+                             beat.data, ~0ULL, beat.denied);
+}
+
+bool TileLinkSenderD::replay_can_send(const tl_d& beat) const {
+  switch (beat.opcode) {
+    case ReleaseAck:
+      return replay_has_received(this->parent, channel_index<tl_c>(),
+                                 beat.source);
+
+    case Grant:
+    case GrantData:
+      if (replay_in_flight(this->parent, channel_index<tl_d>(), beat.sink))
+        return false;
+      // Fall through.
+
+    default:
+      return replay_has_received(this->parent, channel_index<tl_a>(),
+                                 beat.source);
+  }
+}
+
+void TileLinkSenderD::replay_sent(const tl_d& beat, bool first) {
+  if (!first)
+    return;
+
+  switch (beat.opcode) {
+    case ReleaseAck:
+      replay_consume(this->parent, channel_index<tl_c>(), beat.source);
+      break;
+
+    case Grant:
+    case GrantData:
+      this->parent.replay.in_flight.insert(replay_key(channel_index<tl_d>(),
+                                                      beat.sink));
+      // Fall through.
+
+    default:
+      replay_consume(this->parent, channel_index<tl_a>(), beat.source);
+      break;
+  }
+}
+
+void TileLinkReceiverD::replay_received(const tl_d& beat) {
+  TileLinkHost& host = static_cast<TileLinkHost&>(this->parent);
+
+  if (has_payload(beat.opcode)) {
+    this->new_beat_arrived(beat.size);
+    if (!this->all_beats_arrived())
+      return;
+  }
+
+  switch (beat.opcode) {
+    case ReleaseAck:
+      host.replay.in_flight.erase(replay_key(channel_index<tl_c>(),
+                                             beat.source));
+      host.performance.request_finished(channel_index<tl_c>(), beat.source);
+      break;
+
+    case Grant:
+    case GrantData:
+      host.replay.received.insert(replay_key(channel_index<tl_d>(),
+                                             beat.sink));
+      // Fall through.
+
+    default:
+      host.replay.in_flight.erase(replay_key(channel_index<tl_a>(),
+                                             beat.source));
+      host.performance.request_finished(channel_index<tl_a>(), beat.source);
+      break;
+  }
+}
+
 void TileLinkReceiverD::handle_beat(bool randomise, tl_d data) {
   TileLinkHost& host = static_cast<TileLinkHost&>(this->parent);
 
+  if (has_payload(data.opcode)) {
+    this->new_beat_arrived(data.size);
+
+    uint64_t address = the_sim->scoreboard.request_address(this->position(),
+                                                           data.source);
+    the_sim->scoreboard.received(this->payload, TO_HOST, this->position(),
+                                 address, data.size, this->bit_width() / 8,
+                                 this->beat_index(data.size), data.data,
+                                 ~0ULL, data.denied);
+  }
+
   switch (data.opcode) {
     case AccessAck:
     case HintAck:
       host.a.end_transaction(data.source);
+      host.performance.request_finished(channel_index<tl_a>(), data.source);
       break;
 
     case AccessAckData:
-      this->new_beat_arrived(data.size);
-      if (this->all_beats_arrived())
+      if (this->all_beats_arrived()) {
         host.a.end_transaction(data.source);
+        host.performance.request_finished(channel_index<tl_a>(), data.source);
+      }
       break;
 
     case ReleaseAck:
       host.c.end_transaction(data.source);
+      host.performance.request_finished(channel_index<tl_c>(), data.source);
       break;
 
     case Grant:
       host.a.end_transaction(data.source);
+      host.performance.request_finished(channel_index<tl_a>(), data.source);
       host.e.handle_request(randomise, data);
       break;
 
     case GrantData:
-      this->new_beat_arrived(data.size);
       // Create response only when full message has arrived.
       if (this->all_beats_arrived()) {
         host.a.end_transaction(data.source);
+        host.performance.request_finished(channel_index<tl_a>(), data.source);
         host.e.handle_request(randomise, data);
       }
       break;
@@ -430,6 +716,19 @@ void TileLinkSenderE::respond() {
   }
 }
 
+bool TileLinkSenderE::replay_can_send(const tl_e& beat) const {
+  return replay_has_received(this->parent, channel_index<tl_d>(), beat.sink);
+}
+
+void TileLinkSenderE::replay_sent(const tl_e& beat, bool /*first*/) {
+  replay_consume(this->parent, channel_index<tl_d>(), beat.sink);
+}
+
+void TileLinkReceiverE::replay_received(const tl_e& beat) {
+  this->parent.replay.in_flight.erase(replay_key(channel_index<tl_d>(),
+                                                 beat.sink));
+}
+
 void TileLinkReceiverE::handle_beat(bool randomise, tl_e data) {
   assert(this->protocol() == TL_C);
 
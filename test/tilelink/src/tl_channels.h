@@ -5,6 +5,7 @@
 #ifndef TL_CHANNELS_H
 #define TL_CHANNELS_H
 
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <queue>
@@ -15,10 +16,15 @@
 #include "logs.h"
 #include "tilelink.h"
 #include "tl_config.h"
+#include "tl_coverage.h"
 #include "tl_exceptions.h"
 #include "tl_messages.h"
+#include "tl_performance.h"
 #include "tl_printing.h"
 #include "tl_random.h"
+#include "tl_scoreboard.h"
+#include "tl_stimulus.h"
+#include "tl_traffic.h"
 #include "Vtl_wrapper.h"
 
 using std::map;
@@ -38,42 +44,76 @@ extern void next_cycle();
 // If ID & ~mask[i] == base[i], then ID is owned by target[i]. If there are no
 // matches, ID is owned by component 0. If there are multiple matches, the final
 // match wins.
+//
+// The table is expanded into direct lookups when the configuration is loaded.
+// IDs with any bit set above those used by the bases and masks can't match an
+// entry, so only IDs below that width need to be stored.
 class RoutingTable {
 public:
-  RoutingTable(vector<int> base, vector<int> mask, vector<int> target) :
-      base(base), mask(mask), target(target) {
+  RoutingTable(const vector<int>& base, const vector<int>& mask,
+               const vector<int>& target) {
     assert(base.size() == mask.size());
     assert(base.size() == target.size());
+
+    int used_bits = 0;
+    int num_targets = 1;
+    for (size_t i = 0; i < base.size(); i++) {
+      used_bits |= base[i] | mask[i];
+      num_targets = std::max(num_targets, target[i] + 1);
+    }
+
+    int width = 0;
+    while ((used_bits >> width) != 0)
+      width++;
+    assert(width <= 24 && "Routing table too large to expand");
+
+    owners.assign(1 << width, 0);
+    for (size_t i = 0; i < base.size(); i++) {
+      // A base with masked bits set can never match.
+      if (base[i] & mask[i])
+        continue;
+
+      // Enumerate all IDs matching this entry: every combination of mask bits.
+      int masked = 0;
+      do {
+        owners[base[i] | masked] = target[i];
+        masked = (masked - mask[i]) & mask[i];
+      } while (masked != 0);
+    }
+
+    ids.resize(num_targets);
+    for (size_t id = 0; id < owners.size(); id++)
+      ids[owners[id]].push_back(id);
+
+    // If component 0 owns nothing in the table, it still owns everything
+    // beyond it.
+    if (ids[0].empty())
+      ids[0].push_back(owners.size());
   }
 
   // Determine which target a message with the given ID should be routed to.
   int get_owner(int id) const {
-    int owner = 0;
-    for (int i = 0; i < base.size(); i++) {
-      if ((id & ~mask[i]) == base[i]) {
-        owner = target[i];
-      }
-    }
-    return owner;
+    return (id >= 0 && (size_t)id < owners.size()) ? owners[id] : 0;
+  }
+
+  // All IDs associated with the given link (within the expanded table).
+  const vector<int>& get_ids(int link) const {
+    assert(link >= 0 && (size_t)link < ids.size() && !ids[link].empty() &&
+           "No valid routing ID found");
+    return ids[link];
   }
 
   // Find any ID associated with the given link. Assumes such an ID exists.
   int get_any_id(int link) const {
-    // Super simple for now - try all IDs until we find one that matches.
-    // This will not work well if there are many possible IDs.
-    // Could be a bit smarter by inspecting the routing table for matching
-    // targets, but that becomes much more complex when ranges can overlap.
-    for (int i=0; i<1024; i++) {
-      if (get_owner(i) == link)
-        return i;
-    }
-    assert(false && "No valid routing ID found < 1024");
+    return get_ids(link).front();
   }
 
 private:
-  const vector<int> base;
-  const vector<int> mask;
-  const vector<int> target;
+  // Owner of each ID.
+  vector<int> owners;
+
+  // IDs owned by each link, in ascending order.
+  vector<vector<int>> ids;
 };
 
 // Base class for a host/device, with connections to all TileLink channels.
@@ -84,8 +124,11 @@ public:
       protocol(params.protocol), bit_width(params.data_width),
       first_id(params.first_id), last_id(params.last_id),
       max_size(params.max_size), fifo(params.fifo), can_deny(params.can_deny),
-      routing(params.bases, params.masks, params.targets) {
-    // Nothing
+      routing(params.bases, params.masks, params.targets),
+      traffic(params.traffic, params.max_size),
+      performance(params.first_id, params.last_id) {
+    stimulus = nullptr;
+    last_activity = 0;
   }
 
   // Reset flow control signals to their default state.
@@ -94,6 +137,13 @@ public:
   virtual void get_inputs(bool randomise) = 0;
   virtual void set_outputs(bool randomise) = 0;
 
+  // Does this component have any messages to send or transactions which
+  // haven't completed?
+  virtual bool busy() const = 0;
+
+  // Print the state of every channel, for diagnosing hangs.
+  virtual void dump_state(std::ostream& os) const = 0;
+
   virtual string endpoint_type() const = 0;
   string name() const {
     stringstream ss;
@@ -101,6 +151,16 @@ public:
     return ss.str();
   }
 
+  // Identifies this component in recorded stimulus.
+  int stimulus_id() const {
+    return 2 * position + ((endpoint_type() == "Host") ? 0 : 1);
+  }
+
+  // Derive this component's random streams from the global seed.
+  virtual void seed_random(uint64_t seed) {
+    rng.seed(seed, random_stream(0));
+  }
+
   // The TileLink network being tested.
   DUT& dut;
 
@@ -128,6 +188,38 @@ public:
 
   // Routing table telling which sink/source IDs belong to which components.
   const RoutingTable routing;
+
+  // Random decisions made by the component as a whole, e.g. whether to start
+  // a new transaction. Each channel end has its own stream too.
+  TileLinkRandom rng;
+
+  // Shape of random traffic generated by this component.
+  TileLinkTraffic traffic;
+
+  // Bandwidth and latency measurements.
+  TileLinkPerformance performance;
+
+  // Kinds of request generated so far. Hosts only.
+  TileLinkCoverage coverage;
+
+  // Stimulus being recorded or replayed. Set up by the simulation.
+  TileLinkStimulus* stimulus;
+
+  // Messages this component is waiting on during replay.
+  tl_replay_state_t replay;
+
+  // Most recent cycle on which any of this component's channels accepted a
+  // beat.
+  uint64_t last_activity;
+
+protected:
+
+  // Stream numbers are unique to a component type, position and channel.
+  // Channel 0 is the component itself; 1-5 are A-E.
+  uint64_t random_stream(int channel) const {
+    uint64_t type = (endpoint_type() == "Host") ? 0 : 1;
+    return (type << 32) | ((uint64_t)position << 8) | channel;
+  }
 };
 
 // Base class for the start/end of any TileLink channel (A, B, C, D, E).
@@ -143,6 +235,9 @@ public:
   virtual void get_inputs(bool randomise) = 0;
   virtual void set_outputs(bool randomise) = 0;
 
+  // Print this channel end's state, for diagnosing hangs.
+  virtual void dump_state(std::ostream& os) const = 0;
+
   // specialisations have extra methods to generate standard responses
   //   e.g. endpoint<D> has respond(A), respond(C)
 
@@ -158,6 +253,7 @@ public:
   int fifo() const               {return parent.fifo;}
   int can_deny() const           {return parent.can_deny;}
   const RoutingTable& routing_table() const {return parent.routing;}
+  TileLinkTraffic& traffic() const          {return parent.traffic;}
 
   const TileLinkEndpoint& get_parent() {return parent;}
 
@@ -165,6 +261,15 @@ public:
     return parent.name() + channel_name<channel>();
   }
 
+  // Random decisions made on this channel only.
+  TileLinkRandom rng;
+
+  // Progress through the payload crossing this channel, for the scoreboard.
+  tl_payload_t payload = {};
+
+  // Recorded stimulus still to be applied to this channel.
+  tl_replay_t<channel> replay;
+
 protected:
   int first_id() const           {return parent.first_id;}
   int last_id() const            {return parent.last_id;}
@@ -191,13 +296,14 @@ public:
   TileLinkSender(TileLinkEndpoint& parent) : 
       TileLinkChannelEnd<channel>(parent) {
     beat_accepted = false;
+    offered = 0;
   }
 
   // Queue up a change to be applied to a sent beat. Whenever a beat is sent,
   // the queue is checked for outstanding updates, and the next available update
   // is applied, if there is one. A single update may modify multitple fields
   // of the message.
-  void change_next_beat(map<string, int> updates) {
+  void change_next_beat(const tl_modification& updates) {
     modifications.push(updates);
   }
 
@@ -210,21 +316,39 @@ public:
   }
 
   virtual void get_inputs(bool randomise) {
-    if (this->get_valid() && this->get_ready())
+    if (this->get_valid() && this->get_ready()) {
       beat_accepted = true;
+      this->parent.performance.beat_accepted(channel_index<channel>());
+      this->parent.last_activity = (uint64_t)sc_time_stamp();
+
+      TileLinkStimulus& stimulus = *this->parent.stimulus;
+      if (stimulus.recording())
+        stimulus.record_beat(this->parent.stimulus_id(),
+                             channel_index<channel>(), last_beat, offered);
+
+      if (stimulus.replaying())
+        replay_accepted();
+      else if (!to_send.empty())
+        this->delivered(to_send.front(), last_beat);
+    }
   }
 
   // One clock cycle of behaviour.
   virtual void set_outputs(bool randomise) {
+    if (this->parent.stimulus->replaying()) {
+      replay_outputs();
+      return;
+    }
+
     // Handle beats which have been sent but not yet accepted.
     if (this->get_valid()) {
       assert(!to_send.empty());
 
       // Randomly remove the beat from the channel.
-      if (randomise && random_bool(0.2)) {
+      if (randomise && this->traffic().stall(this->rng)) {
         this->set_valid(false);
         to_send.front().unsend();
-        MUNTJAC_LOG(1) << this->name() << " retracted last beat" << std::endl;
+        MUNTJAC_LOG_CATEGORY(1, LOG_TILELINK) << this->name() << " retracted last beat" << std::endl;
       }
       // If keeping the same beat, don't need any of the rest of this function.
       else
@@ -237,24 +361,24 @@ public:
 
     // Randomly reorder the pending requests and responses, except for
     // components which require FIFO order.
-    if (!this->fifo() && randomise && random_bool(0.5)) {
+    if (!this->fifo() && randomise && random_bool(this->rng, 0.5)) {
       this->reorder_requests();
       this->reorder_responses();
     }
 
     // Generate responses to any pending requests and put them in the queue.
     // Randomly stall, i.e. don't respond for a cycle.
-    if (!randomise || random_bool(0.8))
+    if (!randomise || !this->traffic().stall(this->rng))
       this->respond();
 
-    // Send available responses 80% of the time.
-    if (!to_send.empty() && to_send.front().can_send() && !(randomise && random_bool(0.2))) {
+    // Send available responses, unless randomly stalling.
+    if (!to_send.empty() && to_send.front().can_send() && !(randomise && this->traffic().stall(this->rng))) {
       tl_message<channel>& message = to_send.front();
       channel beat = message.next_beat(randomise);
       
       // Modify the beat if there are any modifications queued up.
       // Used to force the system into particular states.
-      map<string, int> updates;
+      tl_modification updates;
       if (!modifications.empty()) {
         updates = modifications.front();
         beat = tl_message<channel>::modify(beat, updates);
@@ -263,13 +387,15 @@ public:
 
       // Instead of duplicate/drop beat, could instead use the tl_message
       // constructor which specifies the number of beats to send.
-      if (updates.find("duplicate_beat") != updates.end())
+      if (updates.has(TL_DUPLICATE_BEAT))
         message.unsend();
 
-      if (updates.find("drop_beat") == updates.end()) {
+      if (!updates.has(TL_DROP_BEAT)) {
         this->set_data(beat);
         this->set_valid(true);
-        MUNTJAC_LOG(1) << this->name() << " sent " << message.current_beat() 
+        last_beat = beat;
+        offered = this->parent.stimulus->now();
+        MUNTJAC_LOG_CATEGORY(1, LOG_TILELINK) << this->name() << " sent " << message.current_beat() 
           << "/" << message.total_beats() << " " << beat << std::endl;
       }
     }
@@ -290,6 +416,17 @@ protected:
   // Reorder the contents of request queue(s).
   virtual void reorder_requests() = 0;
 
+  // A beat of `message` has entered the network.
+  virtual void delivered(const tl_message<channel>& /*message*/,
+                         const channel& /*beat*/) {}
+
+  // Replay: can the message starting with `beat` be sent yet? Messages wait
+  // for the requests they respond to, and for their IDs to become free.
+  virtual bool replay_can_send(const channel& /*beat*/) const {return true;}
+
+  // Replay: a beat has entered the network.
+  virtual void replay_sent(const channel& /*beat*/, bool /*first*/) {}
+
   // Reorder the contents of the response queue.
   virtual void reorder_responses() {
     // Simple for now: move the front response to the back of the queue.
@@ -336,13 +473,13 @@ public:
 
   // An ID for a transaction. IDs can be reused, but not until the previous
   // transaction has completed.
-  int get_transaction_id(bool randomise=false) const {
+  int get_transaction_id(bool randomise=false) {
     if (!can_start_new_transaction())
       throw NoAvailableIDException();
 
     if (randomise) {
       while (true) {
-        int id = this->first_id() + (rand() % (this->last_id() - this->first_id() + 1));
+        int id = random_sample(this->rng, this->first_id(), this->last_id());
         if (transaction_id_available(id))
           return id;
       }
@@ -358,36 +495,131 @@ public:
     }
   }
 
+  // A random transaction ID, preferring IDs which `coverage` has seen least.
+  int get_directed_transaction_id(const TileLinkCoverage& coverage) {
+    if (!can_start_new_transaction())
+      throw NoAvailableIDException();
+
+    vector<uint64_t> cumulative;
+    uint64_t total = 0;
+    for (int id=this->first_id(); id<=this->last_id(); id++) {
+      if (transaction_id_available(id))
+        total += coverage.id_weight(id);
+      cumulative.push_back(total);
+    }
+
+    return this->first_id() + random_weighted(this->rng, cumulative);
+  }
+
   // Like a transaction ID, but we don't care if it's already in use.
-  int get_routing_id(bool randomise=false) const {
+  int get_routing_id(bool randomise=false) {
     if (randomise)
-      return this->first_id() + (rand() % (this->last_id() - this->first_id() + 1));
+      return random_sample(this->rng, this->first_id(), this->last_id());
     else
       return this->first_id();
   }
 
   void start_transaction(int id) {
-    MUNTJAC_LOG(2) << this->name() << " starting transaction ID " << id << endl;
+    MUNTJAC_LOG_CATEGORY(2, LOG_TILELINK) << this->name() << " starting transaction ID " << id << endl;
     assert(transaction_id_available(id));
-    ids_in_use.insert(id);
+    ids_in_use[id] = (uint64_t)sc_time_stamp();
   }
   void end_transaction(int id) {
-    MUNTJAC_LOG(2) << this->name() << " ending transaction ID " << id << endl;
+    MUNTJAC_LOG_CATEGORY(2, LOG_TILELINK) << this->name() << " ending transaction ID " << id << endl;
     assert(!transaction_id_available(id));
     ids_in_use.erase(id);
   }
 
+  // Find the transaction which has been outstanding for longest. Returns false
+  // if there are none.
+  bool oldest_transaction(int& id, uint64_t& start_cycle) const {
+    if (ids_in_use.empty())
+      return false;
+
+    auto oldest = std::min_element(ids_in_use.begin(), ids_in_use.end(),
+        [](const pair<const int, uint64_t>& a,
+           const pair<const int, uint64_t>& b) {return a.second < b.second;});
+    id = oldest->first;
+    start_cycle = oldest->second;
+    return true;
+  }
+
+  bool busy() const {
+    return !to_send.empty() || !ids_in_use.empty() || pending_requests() > 0 ||
+           !this->replay.beats.empty();
+  }
+
+  virtual void dump_state(std::ostream& os) const {
+    os << "  " << this->name() << ": " << to_send.size() << " messages queued";
+    if (!to_send.empty())
+      os << " (sent " << to_send.front().current_beat() << "/"
+         << to_send.front().total_beats() << " beats of first)";
+    os << ", " << pending_requests() << " requests awaiting a response"
+       << (this->get_valid() ? ", beat waiting to be accepted" : "") << endl;
+
+    uint64_t now = (uint64_t)sc_time_stamp();
+    for (auto& transaction : ids_in_use)
+      os << "    ID " << transaction.first << " in use for "
+         << (now - transaction.second) << " cycles" << endl;
+  }
+
 protected:
 
-  // Source/sink IDs currently in use. Most channels only allow one outstanding
-  // transaction per ID.
-  set<int> ids_in_use;
+  // Requests received from other channels which haven't been responded to yet.
+  virtual int pending_requests() const {return 0;}
+
+  // Source/sink IDs currently in use, and the cycle each transaction started.
+  // Most channels only allow one outstanding transaction per ID.
+  map<int, uint64_t> ids_in_use;
 
   queue<tl_message<channel>> to_send;
-  queue<map<string, int>> modifications;
+  queue<tl_modification> modifications;
 
   // If we sent a beat onto the network, was it accepted?
   bool beat_accepted;
+
+  // The beat most recently put on the network, and the cycle it was first
+  // offered.
+  channel last_beat;
+  uint64_t offered;
+
+private:
+
+  // Put the next recorded beat on the network once it is due and any messages
+  // it depends on have arrived. Fast replay doesn't wait for the recorded
+  // cycle.
+  void replay_outputs() {
+    const TileLinkStimulus& stimulus = *this->parent.stimulus;
+
+    if (this->get_valid() || this->replay.beats.empty())
+      return;
+
+    uint64_t due = this->replay.beats.front().first;
+    const channel& beat = this->replay.beats.front().second;
+
+    if (!stimulus.fast() && due > stimulus.now())
+      return;
+    if (this->replay.beats_sent == 0 && !this->replay_can_send(beat))
+      return;
+
+    this->set_data(beat);
+    this->set_valid(true);
+    last_beat = beat;
+    offered = stimulus.now();
+    MUNTJAC_LOG_CATEGORY(1, LOG_TILELINK) << this->name() << " replayed " << beat << std::endl;
+  }
+
+  void replay_accepted() {
+    bool first = this->replay.beats_sent == 0;
+    int beats = message_beats(last_beat, this->bit_width() / 8);
+
+    if (++this->replay.beats_sent == beats)
+      this->replay.beats_sent = 0;
+
+    this->replay_sent(last_beat, first);
+    this->replay.beats.pop_front();
+    this->parent.stimulus->beat_replayed();
+  }
 };
 
 class TileLinkSenderA : public TileLinkSender<tl_a> {
@@ -421,7 +653,7 @@ public:
   // Create and enqueue a new request. `requirements` can be used to force
   // fields to have particular values.
   void queue_request(bool randomise, 
-                     map<string, int> requirements = map<string, int>());
+                     const tl_modification& requirements = tl_modification());
 
 protected:
   virtual void respond();
@@ -429,6 +661,11 @@ protected:
   virtual void reorder_requests() {
     // No requests to reorder.
   }
+
+  virtual void delivered(const tl_message<tl_a>& message, const tl_a& beat);
+
+  virtual bool replay_can_send(const tl_a& beat) const;
+  virtual void replay_sent(const tl_a& beat, bool first);
 };
 
 class TileLinkSenderB : public TileLinkSender<tl_b> {
@@ -466,12 +703,15 @@ public:
   // Create and enqueue a new request. `requirements` can be used to force
   // fields to have particular values.
   void queue_request(bool randomise, 
-                     map<string, int> requirements = map<string, int>());
+                     const tl_modification& requirements = tl_modification());
 
 protected:
 
   virtual void respond();
 
+  virtual bool replay_can_send(const tl_b& beat) const;
+  virtual void replay_sent(const tl_b& beat, bool first);
+
   virtual void reorder_requests() {
     // Simple for now: move the front request to the back of the queue.
     if (!a_requests.empty()) {
@@ -480,6 +720,8 @@ protected:
     }
   }
 
+  virtual int pending_requests() const {return a_requests.size();}
+
 private:
   // If we are not able to respond to a request immediately, queue it here.
   queue<pair<bool, tl_a>> a_requests;
@@ -522,12 +764,17 @@ public:
   // Create and enqueue a new request. `requirements` can be used to force
   // fields to have particular values.
   void queue_request(bool randomise, 
-                     map<string, int> requirements = map<string, int>());
+                     const tl_modification& requirements = tl_modification());
 
 protected:
 
   virtual void respond();
 
+  virtual void delivered(const tl_message<tl_c>& message, const tl_c& beat);
+
+  virtual bool replay_can_send(const tl_c& beat) const;
+  virtual void replay_sent(const tl_c& beat, bool first);
+
   virtual void reorder_requests() {
     // Simple for now: move the front request to the back of the queue.
     if (!b_requests.empty()) {
@@ -536,6 +783,8 @@ protected:
     }
   }
 
+  virtual int pending_requests() const {return b_requests.size();}
+
 private:
   // If we are not able to respond to a request immediately, queue it here.
   queue<pair<bool, tl_b>> b_requests;
@@ -586,6 +835,11 @@ protected:
 
   virtual void respond();
 
+  virtual void delivered(const tl_message<tl_d>& message, const tl_d& beat);
+
+  virtual bool replay_can_send(const tl_d& beat) const;
+  virtual void replay_sent(const tl_d& beat, bool first);
+
   virtual void reorder_requests() {
     // Simple for now: move the front request to the back of the queue.
 
@@ -610,6 +864,10 @@ protected:
     }
   }
 
+  virtual int pending_requests() const {
+    return a_requests.size() + c_requests.size();
+  }
+
 private:
   // If we are not able to respond to a request immediately, queue it here.
   queue<pair<bool, tl_a>> a_requests;
@@ -652,6 +910,9 @@ protected:
 
   virtual void respond();
 
+  virtual bool replay_can_send(const tl_e& beat) const;
+  virtual void replay_sent(const tl_e& beat, bool first);
+
   virtual void reorder_requests() {
     // Simple for now: move the front request to the back of the queue.
     if (!d_requests.empty()) {
@@ -660,6 +921,8 @@ protected:
     }
   }
 
+  virtual int pending_requests() const {return d_requests.size();}
+
 private:
   // If we are not able to respond to a request immediately, queue it here.
   queue<pair<bool, tl_d>> d_requests;
@@ -673,6 +936,7 @@ public:
       TileLinkChannelEnd<channel>(parent) {
     beats_remaining = 0;
     ready = true;
+    recorded_ready = true;
   }
 
   virtual bool get_valid() const = 0;
@@ -701,21 +965,54 @@ public:
 
   // Respond to inputs immediately if available.
   virtual void get_inputs(bool randomise) {
+    TileLinkStimulus& stimulus = *this->parent.stimulus;
+
     if (this->get_valid() && ready) {
       channel beat = this->get_data();
-      MUNTJAC_LOG(1) << this->name() << " received " << beat << std::endl;
-      this->handle_beat(randomise, beat);
+      MUNTJAC_LOG_CATEGORY(1, LOG_TILELINK) << this->name() << " received " << beat << std::endl;
+      this->parent.performance.beat_accepted(channel_index<channel>());
+      this->parent.last_activity = (uint64_t)sc_time_stamp();
+
+      // Replayed stimulus already contains the responses.
+      if (stimulus.replaying())
+        this->replay_received(beat);
+      else
+        this->handle_beat(randomise, beat);
     }
 
     // Randomly stall next cycle. Can't stall this cycle because we've
     // already announced whether we are `ready`.
-    ready = !randomise || random_bool(0.8);
+    if (!stimulus.replaying())
+      ready = !randomise || !this->traffic().apply_backpressure(this->rng);
+    else if (stimulus.fast())
+      ready = true;
+    else {
+      auto& schedule = this->replay.ready;
+      while (!schedule.empty() && schedule.front().first <= stimulus.now()) {
+        ready = schedule.front().second;
+        schedule.pop_front();
+      }
+    }
+
+    if (stimulus.recording() && ready != recorded_ready) {
+      stimulus.record_ready(this->parent.stimulus_id(),
+                            channel_index<channel>(), ready);
+      recorded_ready = ready;
+    }
   }
 
   virtual void set_outputs(bool randomise) {
     // Do nothing. (Flow control is handled elsewhere.)
   }
 
+  virtual void dump_state(std::ostream& os) const {
+    os << "  " << this->name() << ": " << (ready ? "ready" : "not ready")
+       << (this->get_valid() ? ", beat waiting to be accepted" : "");
+    if (!all_beats_arrived())
+      os << ", " << beats_remaining << " beats of current message to come";
+    os << endl;
+  }
+
 protected:
 
   // Determine whether this is the final beat of a multi-beat message.
@@ -729,6 +1026,13 @@ protected:
   bool all_beats_arrived() const {
     return beats_remaining == 0;
   }
+  // Position of the most recent beat within its message.
+  int beat_index(int size) const {
+    return this->num_beats(size) - beats_remaining - 1;
+  }
+
+  // Replay: a beat has arrived. Update the messages the parent is waiting on.
+  virtual void replay_received(const channel& /*beat*/) {}
 
 private:
 
@@ -738,6 +1042,9 @@ private:
   // Is this component ready to receive a new beat?
   bool ready;
 
+  // Value of `ready` in the stimulus being recorded.
+  bool recorded_ready;
+
 };
 
 class TileLinkReceiverA : public TileLinkReceiver<tl_a> {
@@ -769,6 +1076,9 @@ public:
   }
 
   virtual void handle_beat(bool randomise, tl_a data);
+
+protected:
+  virtual void replay_received(const tl_a& beat);
 };
 
 class TileLinkReceiverB : public TileLinkReceiver<tl_b> {
@@ -797,6 +1107,9 @@ public:
   }
 
   virtual void handle_beat(bool randomise, tl_b data);
+
+protected:
+  virtual void replay_received(const tl_b& beat);
 };
 
 class TileLinkReceiverC : public TileLinkReceiver<tl_c> {
@@ -827,6 +1140,9 @@ public:
   }
 
   virtual void handle_beat(bool randomise, tl_c data);
+
+protected:
+  virtual void replay_received(const tl_c& beat);
 };
 
 class TileLinkReceiverD : public TileLinkReceiver<tl_d> {
@@ -858,6 +1174,9 @@ public:
   }
 
   virtual void handle_beat(bool randomise, tl_d data);
+
+protected:
+  virtual void replay_received(const tl_d& beat);
 };
 
 class TileLinkReceiverE : public TileLinkReceiver<tl_e> {
@@ -882,6 +1201,9 @@ public:
   }
 
   virtual void handle_beat(bool randomise, tl_e data);
+
+protected:
+  virtual void replay_received(const tl_e& beat);
 };
 
 
@@ -897,6 +1219,15 @@ public:
     // Nothing
   }
 
+  virtual void seed_random(uint64_t seed) {
+    TileLinkEndpoint::seed_random(seed);
+    a.rng.seed(seed, random_stream(1));
+    b.rng.seed(seed, random_stream(2));
+    c.rng.seed(seed, random_stream(3));
+    d.rng.seed(seed, random_stream(4));
+    e.rng.seed(seed, random_stream(5));
+  }
+
   virtual void set_flow_control() {
     a.set_flow_control();
     b.set_flow_control();
@@ -916,10 +1247,9 @@ public:
   virtual void set_outputs(bool randomise) {
     // Randomly inject new requests.
     if (randomise) {
-      // 1 in 10 chance in each clock cycle. Reasonable?
-      if (random_bool(0.1))
+      if (traffic.inject(rng))
         a.queue_request(true);
-      if (random_bool(0.1))
+      if (traffic.inject(rng))
         c.queue_request(true);
     }
 
@@ -930,6 +1260,18 @@ public:
     e.set_outputs(randomise);
   }
 
+  virtual bool busy() const {
+    return a.busy() || c.busy() || e.busy();
+  }
+
+  virtual void dump_state(std::ostream& os) const {
+    a.dump_state(os);
+    b.dump_state(os);
+    c.dump_state(os);
+    d.dump_state(os);
+    e.dump_state(os);
+  }
+
   virtual string endpoint_type() const {
     return "Host";
   }
@@ -953,6 +1295,15 @@ public:
     // Nothing
   }
 
+  virtual void seed_random(uint64_t seed) {
+    TileLinkEndpoint::seed_random(seed);
+    a.rng.seed(seed, random_stream(1));
+    b.rng.seed(seed, random_stream(2));
+    c.rng.seed(seed, random_stream(3));
+    d.rng.seed(seed, random_stream(4));
+    e.rng.seed(seed, random_stream(5));
+  }
+
   virtual void set_flow_control() {
     a.set_flow_control();
     b.set_flow_control();
@@ -972,8 +1323,7 @@ public:
   virtual void set_outputs(bool randomise) {
     // Randomly inject new requests.
     if (randomise) {
-      // 1 in 20 chance in each clock cycle. Reasonable?
-      if (random_bool(0.05))
+      if (traffic.inject(rng))
         b.queue_request(true);
     }
 
@@ -984,6 +1334,18 @@ public:
     e.set_outputs(randomise);
   }
 
+  virtual bool busy() const {
+    return b.busy() || d.busy();
+  }
+
+  virtual void dump_state(std::ostream& os) const {
+    a.dump_state(os);
+    b.dump_state(os);
+    c.dump_state(os);
+    d.dump_state(os);
+    e.dump_state(os);
+  }
+
   virtual string endpoint_type() const {
     return "Device";
   }
@@ -10,6 +10,7 @@
 #include "tl_config.h"
 
 using std::ifstream;
+using std::stof;
 using std::stoi;
 using std::string;
 using std::stringstream;
@@ -67,8 +68,40 @@ vector<int> parse_int_list(string& line) {
   return result;
 }
 
-tl_endpoint_config_t parse_parameters(vector<string>& data) {
+tl_address_pattern_e parse_address_pattern(const string& value) {
+  if (value == "random")
+    return ADDRESS_RANDOM;
+  else if (value == "sequential")
+    return ADDRESS_SEQUENTIAL;
+  else if (value == "strided")
+    return ADDRESS_STRIDED;
+  else if (value == "hotspot")
+    return ADDRESS_HOTSPOT;
+
+  MUNTJAC_ERROR << "Unknown address pattern selected: " << value << endl;
+  exit(1);
+}
+
+// Default traffic, which gives good coverage of protocol corner cases, but
+// doesn't saturate the network.
+tl_traffic_config_t default_traffic(const string& type) {
+  tl_traffic_config_t traffic;
+
+  traffic.injection_rate = (type == "host") ? 0.1 : 0.05;
+  traffic.address_pattern = ADDRESS_RANDOM;
+  traffic.address_stride = 64;
+  traffic.hotspot_size = 64;
+  traffic.hotspot_rate = 0.9;
+  traffic.stall_rate = 0.2;
+  traffic.backpressure = 0.2;
+
+  return traffic;
+}
+
+tl_endpoint_config_t parse_parameters(vector<string>& data,
+                                      const string& type) {
   tl_endpoint_config_t component;
+  component.traffic = default_traffic(type);
 
   for (string line : data) {
     if (line.find(":") == string::npos) {
@@ -118,6 +151,24 @@ tl_endpoint_config_t parse_parameters(vector<string>& data) {
       component.masks = parse_int_list(value);
     else if (ends_with(name, "Target"))
       component.targets = parse_int_list(value);
+    else if (name == "InjectionRate")
+      component.traffic.injection_rate = stof(value);
+    else if (name == "SizeWeights")
+      component.traffic.size_weights = parse_int_list(value);
+    else if (name == "OpcodeWeights")
+      component.traffic.opcode_weights = parse_int_list(value);
+    else if (name == "AddressPattern")
+      component.traffic.address_pattern = parse_address_pattern(value);
+    else if (name == "AddressStride")
+      component.traffic.address_stride = stoi(value);
+    else if (name == "HotspotSize")
+      component.traffic.hotspot_size = stoi(value);
+    else if (name == "HotspotRate")
+      component.traffic.hotspot_rate = stof(value);
+    else if (name == "StallRate")
+      component.traffic.stall_rate = stof(value);
+    else if (name == "Backpressure")
+      component.traffic.backpressure = stof(value);
     else
       MUNTJAC_WARN << "Unknown configuration parameter ignored: " << name << endl;
   }
@@ -130,7 +181,7 @@ void add_component(tl_config_t& config, string& type, vector<string>& data) {
     return;
 
   assert(type != "");
-  tl_endpoint_config_t endpoint = parse_parameters(data);
+  tl_endpoint_config_t endpoint = parse_parameters(data, type);
 
   if (type == "host")
     config.hosts.push_back(endpoint);
@@ -188,7 +239,7 @@ tl_config_t read_config(string filename) {
 
   add_component(config, section, component);
 
-  MUNTJAC_LOG(1) << "Configured " << config.hosts.size() << " hosts and " 
+  MUNTJAC_LOG_CATEGORY(1, LOG_TILELINK) << "Configured " << config.hosts.size() << " hosts and " 
       << config.devices.size() << " devices from " << filename << endl;
 
   file.close();
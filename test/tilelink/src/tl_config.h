@@ -9,6 +9,41 @@
 #include <vector>
 #include "tilelink.h"
 
+typedef enum {
+  ADDRESS_RANDOM,      // Uniform across the address range
+  ADDRESS_SEQUENTIAL,  // Each request follows on from the previous one
+  ADDRESS_STRIDED,     // Fixed distance between consecutive requests
+  ADDRESS_HOTSPOT      // Concentrated in a small region
+} tl_address_pattern_e;
+
+// Random traffic generated by a single host/device. All probabilities are per
+// clock cycle.
+typedef struct {
+  // Probability of starting a new request: A and C for hosts, B for devices.
+  float injection_rate;
+
+  // Relative frequency of each request size, indexed by log2(bytes). Sizes
+  // above MaxSize are ignored. Empty means all sizes are equally likely.
+  std::vector<int> size_weights;
+
+  // Relative frequency of each A opcode, indexed by tl_a_op_e. Opcodes the
+  // protocol doesn't support are never used. Empty means all are equally
+  // likely.
+  std::vector<int> opcode_weights;
+
+  tl_address_pattern_e address_pattern;
+  int address_stride;   // Bytes between requests for ADDRESS_STRIDED
+  int hotspot_size;     // Bytes in the hotspot for ADDRESS_HOTSPOT
+  float hotspot_rate;   // Fraction of requests to the hotspot
+
+  // Probability that a sender delays a beat it could send, retracts a beat
+  // which hasn't been accepted, or delays responding to a request.
+  float stall_rate;
+
+  // Probability that a receiver is not ready to accept a beat.
+  float backpressure;
+} tl_traffic_config_t;
+
 // Configuration of a single host/device.
 typedef struct {
   // Highest protocol this component supports. (TL_C > TL_UH > TL_UL)
@@ -34,6 +69,9 @@ typedef struct {
   std::vector<int> bases;
   std::vector<int> masks;
   std::vector<int> targets;
+
+  // Random traffic profile.
+  tl_traffic_config_t traffic;
 } tl_endpoint_config_t;
 
 // Configuration of all endpoints of a DUT.
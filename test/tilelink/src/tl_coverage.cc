@@ -0,0 +1,134 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+
+#include "logs.h"
+#include "tl_coverage.h"
+
+extern tl_protocol_e max_common_protocol(tl_protocol_e p1, tl_protocol_e p2);
+
+// Number of opcodes in tl_a_op_e, and the most params any of them has.
+static const int NUM_OPCODES = AcquirePerm + 1;
+static const int MAX_PARAMS = 5;
+
+// Number of params of each opcode which are generated randomly. This matches
+// the random_*_param() functions.
+static int num_params(tl_a_op_e opcode) {
+  switch (opcode) {
+    case ArithmeticData: return 5;
+    case LogicalData:    return 4;
+    case Intent:         return 2;
+    case AcquireBlock:
+    case AcquirePerm:    return 3;
+    default:             return 1;
+  }
+}
+
+TileLinkCoverage::TileLinkCoverage() {
+  directed_mode = false;
+  num_devices = 0;
+  max_size = 0;
+  first_id = 0;
+}
+
+void TileLinkCoverage::init(tl_protocol_e host_protocol,
+                            const vector<tl_protocol_e>& device_protocols,
+                            const TileLinkTraffic& traffic, int max_size,
+                            int first_id, int last_id) {
+  this->num_devices = device_protocols.size();
+  this->max_size = max_size;
+  this->first_id = first_id;
+
+  index.assign(num_devices * NUM_OPCODES * MAX_PARAMS * (max_size + 1), -1);
+
+  for (int device=0; device<num_devices; device++) {
+    tl_protocol_e protocol = max_common_protocol(host_protocol,
+                                                 device_protocols[device]);
+
+    for (tl_a_op_e opcode : a_opcodes(protocol)) {
+      for (int param=0; param<num_params(opcode); param++) {
+        for (int size=0; size<=max_size; size++) {
+          uint64_t profile_weight = traffic.opcode_weight(opcode) *
+                                    traffic.size_weight(size);
+          if (profile_weight == 0)
+            continue;
+
+          index[bin_index(device, opcode, param, size)] = bins.size();
+          bins.push_back({device, opcode, param, size});
+          profile_weights.push_back(profile_weight);
+        }
+      }
+    }
+  }
+
+  hits.assign(bins.size(), 0);
+  id_hits.assign(last_id - first_id + 1, 0);
+}
+
+int TileLinkCoverage::bin_index(int device, int opcode, int param,
+                                int size) const {
+  return ((device * NUM_OPCODES + opcode) * MAX_PARAMS + param) *
+         (max_size + 1) + size;
+}
+
+void TileLinkCoverage::request_sent(const tl_a& request) {
+  // Device position from the address: see TileLinkSender::get_address().
+  int device = request.address >> 28;
+
+  if (device < num_devices && request.opcode < NUM_OPCODES &&
+      request.param < MAX_PARAMS && request.size <= max_size) {
+    int bin = index[bin_index(device, request.opcode, request.param,
+                              request.size)];
+    if (bin >= 0)
+      hits[bin]++;
+  }
+
+  int id = request.source - first_id;
+  if (id >= 0 && (size_t)id < id_hits.size())
+    id_hits[id]++;
+}
+
+uint64_t TileLinkCoverage::weight(uint64_t hits) {
+  // Inverse frequency: bins which have never been hit are preferred, and
+  // bins hit equally often are equally likely.
+  const uint64_t SCALE = 1 << 16;
+  return std::max<uint64_t>(1, SCALE / (hits + 1));
+}
+
+void TileLinkCoverage::update() {
+  uint64_t total = 0;
+
+  cumulative.clear();
+  for (size_t bin=0; bin<bins.size(); bin++) {
+    total += profile_weights[bin] * weight(hits[bin]);
+    cumulative.push_back(total);
+  }
+
+  if (total == 0) {
+    MUNTJAC_ERROR << "Traffic profile doesn't allow any requests to be "
+                  << "generated" << endl;
+    exit(1);
+  }
+}
+
+const tl_a_bin_t& TileLinkCoverage::choose(TileLinkRandom& rng) const {
+  assert(directed_mode);
+  return bins[random_weighted(rng, cumulative)];
+}
+
+uint64_t TileLinkCoverage::id_weight(int id) const {
+  id -= first_id;
+  return (id >= 0 && (size_t)id < id_hits.size()) ? weight(id_hits[id]) : 1;
+}
+
+int TileLinkCoverage::bins_hit() const {
+  return std::count_if(hits.begin(), hits.end(),
+                       [](uint64_t count) {return count > 0;});
+}
+
+int TileLinkCoverage::ids_hit() const {
+  return std::count_if(id_hits.begin(), id_hits.end(),
+                       [](uint64_t count) {return count > 0;});
+}
@@ -0,0 +1,96 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TL_COVERAGE_H
+#define TL_COVERAGE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "tilelink.h"
+#include "tl_random.h"
+#include "tl_traffic.h"
+
+using std::vector;
+
+// One kind of A request a host can generate.
+typedef struct {
+  int       device;
+  tl_a_op_e opcode;
+  int       param;
+  int       size;
+} tl_a_bin_t;
+
+// Functional coverage of the A requests generated by one host: how often each
+// combination of target device, opcode, param and size has been sent, and
+// how often each source ID has been used.
+//
+// When directed, new requests are drawn in inverse proportion to how often
+// their bin has been hit so far, so rare combinations (e.g. a particular
+// atomic on a narrow device) are reached quickly. The traffic profile's
+// opcode and size weights still apply, and bins they exclude are never
+// generated or counted as coverage holes.
+class TileLinkCoverage {
+public:
+  TileLinkCoverage();
+
+  // Enumerate the requests a host can send to each device, given the
+  // protocols supported and its traffic profile.
+  void init(tl_protocol_e host_protocol,
+            const vector<tl_protocol_e>& device_protocols,
+            const TileLinkTraffic& traffic, int max_size, int first_id,
+            int last_id);
+
+  // Count a request whose first beat has entered the network.
+  void request_sent(const tl_a& request);
+
+  // Start biasing new requests towards coverage holes.
+  void direct() {
+    directed_mode = true;
+    update();
+  }
+  bool directed() const {return directed_mode;}
+
+  // Recompute the bias from the latest hit counts.
+  void update();
+
+  // Choose the kind of a new request. Only valid when directed.
+  const tl_a_bin_t& choose(TileLinkRandom& rng) const;
+
+  // Relative preference for using source ID `id` in a new request.
+  uint64_t id_weight(int id) const;
+
+  int bins_hit() const;
+  int num_bins() const {return bins.size();}
+  int ids_hit() const;
+  int num_ids() const  {return id_hits.size();}
+
+private:
+
+  // Dense index of a bin, or -1 if the request can't be generated.
+  int bin_index(int device, int opcode, int param, int size) const;
+
+  // Weight given to a bin or ID which has been hit `hits` times.
+  static uint64_t weight(uint64_t hits);
+
+  bool directed_mode;
+
+  int num_devices;
+  int max_size;
+  int first_id;
+
+  vector<tl_a_bin_t> bins;
+  vector<uint64_t> profile_weights;
+  vector<uint64_t> hits;
+
+  // Running total of bin weights, for choose().
+  vector<uint64_t> cumulative;
+
+  // Position in `bins` of each (device, opcode, param, size), or -1.
+  vector<int> index;
+
+  vector<uint64_t> id_hits;
+};
+
+#endif // TL_COVERAGE_H
@@ -7,6 +7,10 @@
 #ifndef TL_HARNESS_H
 #define TL_HARNESS_H
 
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
 #include <vector>
 #include <verilated.h>
 
@@ -14,6 +18,8 @@
 #include "simulation.h"
 #include "tl_channels.h"
 #include "tl_config.h"
+#include "tl_scoreboard.h"
+#include "tl_stimulus.h"
 
 using std::vector;
 class TileLinkSimulation;
@@ -33,12 +39,25 @@ public:
       tests(tests) {
     sim_duration = 0;
     randomise = false;
+    replay_fast = false;
+    monitor_progress = false;
+    coverage_interval = 0;
+    max_age = 100000;
+    watchdog = 10000;
+    random_seed = 0;
 
     this->args.set_description("Usage: " + name + " [simulator args] [tests to run]");
     this->args.add_argument("--list-tests", "List all available tests");
+    this->args.add_argument("--perf", "Write bandwidth/latency statistics for the --run traffic to a file (.json for JSON, otherwise CSV)", ArgumentParser::ARGS_ONE);
     this->args.add_argument("--config", "Load host/device configuration from a file", ArgumentParser::ARGS_ONE);
     this->args.add_argument("--random-seed", "Set the random seed", ArgumentParser::ARGS_ONE);
     this->args.add_argument("--run", "Generate random traffic for the given duration (in cycles)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--record", "Record all stimulus applied to the network in a file", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--replay", "Replay stimulus from a file instead of running tests", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--replay-fast", "Ignore recorded timing when replaying: send everything as soon as possible");
+    this->args.add_argument("--coverage-directed", "Bias random requests towards kinds which haven't been generated yet, re-weighting every N cycles", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--max-age", "Abort if a transaction is outstanding for more than this many cycles during random traffic or replay (default 100000, 0 to disable)", ArgumentParser::ARGS_ONE);
+    this->args.add_argument("--watchdog", "Abort if no beat is accepted for this many cycles while transactions are outstanding (default 10000, 0 to disable)", ArgumentParser::ARGS_ONE);
   }
 
   virtual ~TileLinkSimulation() {
@@ -54,24 +73,28 @@ public:
   TileLinkHost&   host(int position)   const {return *hosts[position];}
   TileLinkDevice& device(int position) const {return *devices[position];}
 
-  TileLinkHost&   random_host(tl_protocol_e min_protocol=TL_UL) const {
-    // Assuming a host with the required protocol exists.
-    while (true) {
-      auto& host = *hosts[rand() % num_hosts()];
-      if (host.protocol >= min_protocol)
-        return host;
-    }
+  // Choose a host/device supporting at least `min_protocol`, using the
+  // caller's random stream. Assumes such a host/device exists.
+  TileLinkHost&   random_host(TileLinkRandom& rng,
+                              tl_protocol_e min_protocol=TL_UL) const {
+    auto& eligible = eligible_hosts[min_protocol];
+    assert(!eligible.empty() && "No host supports the required protocol");
+    return *eligible[rng.below(eligible.size())];
   }
 
-  TileLinkDevice& random_device(tl_protocol_e min_protocol=TL_UL) const {
-    // Assuming a device with the required protocol exists.
-    while (true) {
-      auto& device = *devices[rand() % num_devices()];
-      if (device.protocol >= min_protocol)
-        return device;
-    }
+  TileLinkDevice& random_device(TileLinkRandom& rng,
+                                tl_protocol_e min_protocol=TL_UL) const {
+    auto& eligible = eligible_devices[min_protocol];
+    assert(!eligible.empty() && "No device supports the required protocol");
+    return *eligible[rng.below(eligible.size())];
   }
 
+  // Checks payloads of random traffic, and holds the contents of each device.
+  TileLinkScoreboard scoreboard;
+
+  // Stimulus being recorded to or replayed from a file, if requested.
+  TileLinkStimulus stimulus;
+
   // Run a simulation for the given duration. Random requests will be generated 
   // during simulation, and responses will have random valid effects. During the
   // final `drain` clock cycles, no new requests will be generated.
@@ -95,6 +118,41 @@ public:
     for (int device=0; device<config.devices.size(); device++)
       devices.push_back(new TileLinkDevice(this->dut, device, config.devices[device]));
 
+    scoreboard.init(devices.size());
+
+    for (auto host : hosts)
+      host->stimulus = &stimulus;
+    for (auto device : devices)
+      device->stimulus = &stimulus;
+
+    if (!record_file.empty())
+      stimulus.record(record_file, num_hosts(), num_devices());
+    if (!replay_file.empty())
+      load_stimulus();
+
+    vector<tl_protocol_e> device_protocols;
+    for (auto device : devices)
+      device_protocols.push_back(device->protocol);
+    for (auto host : hosts)
+      host->coverage.init(host->protocol, device_protocols, host->traffic,
+                          host->max_size, host->first_id, host->last_id);
+
+    for (auto host : hosts)
+      host->seed_random(random_seed);
+    for (auto device : devices)
+      device->seed_random(random_seed);
+
+    for (int protocol=TL_UL; protocol<=TL_C; protocol++) {
+      for (auto host : hosts)
+        if (host->protocol >= protocol)
+          eligible_hosts[protocol].push_back(host);
+      for (auto device : devices)
+        if (device->protocol >= protocol)
+          eligible_devices[protocol].push_back(device);
+    }
+
+    report_seed_on_failure();
+
     dut.clk_i = 1;
     dut.rst_ni = 1;
 
@@ -112,10 +170,39 @@ public:
     cycle_second_half();
     this->trace_state_change();    
     this->cycle += 0.5;
+
+    scoreboard.end_cycle();
+
+    for (auto host : hosts)
+      host->performance.tick();
+    for (auto device : devices)
+      device->performance.tick();
+
+    stimulus.tick();
+
+    if (monitor_progress && (uint64_t)this->simulation_time() % check_interval == 0)
+      check_progress();
+
+    if (randomise && coverage_interval > 0 &&
+        (uint64_t)this->simulation_time() % coverage_interval == 0) {
+      for (auto host : hosts)
+        host->coverage.update();
+    }
   }
 
   void run_tests() {
     randomise = false;
+
+    if (stimulus.replaying()) {
+      monitor_progress = true;
+      run_replay();
+      end_simulation();
+      this->trace_close();
+      stimulus.close();
+      cout << "No assertions triggered" << endl;
+      return;
+    }
+
     for (int test : tests_to_run) {
       cout << "Test selected: " << tests[test].description << endl;
       tests[test].function(*this);
@@ -125,12 +212,32 @@ public:
         next_cycle();
     }
 
-    if (sim_duration > 0)
+    if (sim_duration > 0) {
+      for (auto host : hosts)
+        host->performance.reset();
+      for (auto device : devices)
+        device->performance.reset();
+
+      if (coverage_interval > 0) {
+        for (auto host : hosts)
+          host->coverage.direct();
+      }
+
+      scoreboard.enable();
+      monitor_progress = true;
       run(true, sim_duration, 1000);
+      monitor_progress = false;
+      scoreboard.print_summary(cout);
+      print_coverage_summary();
+
+      if (!perf_file.empty())
+        write_performance_report();
+    }
 
     end_simulation();
 
     this->trace_close();
+    stimulus.close();
 
     cout << "No assertions triggered" << endl;
   }
@@ -151,12 +258,38 @@ public:
     if (this->args.found_arg("--config"))
       config_file = this->args.get_arg("--config");
 
+    if (this->args.found_arg("--perf"))
+      perf_file = this->args.get_arg("--perf");
+
     if (this->args.found_arg("--random-seed"))
-      srand(std::stoi(this->args.get_arg("--random-seed")));
+      random_seed = std::stoull(this->args.get_arg("--random-seed"));
     
     if (this->args.found_arg("--run"))
       sim_duration = std::stoi(this->args.get_arg("--run"));
 
+    if (this->args.found_arg("--record"))
+      record_file = this->args.get_arg("--record");
+
+    if (this->args.found_arg("--replay"))
+      replay_file = this->args.get_arg("--replay");
+
+    if (this->args.found_arg("--replay-fast"))
+      replay_fast = true;
+
+    if (this->args.found_arg("--coverage-directed"))
+      coverage_interval = std::stoull(this->args.get_arg("--coverage-directed"));
+
+    if (this->args.found_arg("--max-age"))
+      max_age = std::stoull(this->args.get_arg("--max-age"));
+
+    if (this->args.found_arg("--watchdog"))
+      watchdog = std::stoull(this->args.get_arg("--watchdog"));
+
+    if (!record_file.empty() && !replay_file.empty()) {
+      MUNTJAC_ERROR << "Can't --record and --replay at the same time" << endl;
+      exit(1);
+    }
+
     // If we found an unknown argument, assume it's the beginning of a list of
     // tests to run.
     if (this->args.get_args_parsed() < argc) {
@@ -209,6 +342,254 @@ protected:
 
 private:
 
+  // Assertions (in C++ or Verilog) and uncaught exceptions all abort the
+  // simulation. Print the seed first, so the failure can be reproduced.
+  void report_seed_on_failure() const {
+    static char message[64];
+    static int length;
+    length = snprintf(message, sizeof(message), "Random seed: %llu\n",
+                      (unsigned long long)random_seed);
+
+    std::signal(SIGABRT, [](int) {
+      // Only async-signal-safe functions allowed here.
+      ssize_t ignored = write(STDERR_FILENO, message, length);
+      (void)ignored;
+      std::signal(SIGABRT, SIG_DFL);
+      std::raise(SIGABRT);
+    });
+  }
+
+  void write_performance_report() const {
+    std::ofstream report(perf_file);
+    if (!report.good()) {
+      MUNTJAC_ERROR << "Unable to write performance report to " << perf_file << endl;
+      exit(1);
+    }
+
+    bool json = perf_file.size() >= 5 &&
+                perf_file.compare(perf_file.size() - 5, 5, ".json") == 0;
+
+    if (json) {
+      report << "{\"config\": \"" << config_file << "\", \"seed\": "
+             << random_seed << ",\n \"hosts\": [";
+      for (int i=0; i<num_hosts(); i++) {
+        report << (i ? ",\n   " : "\n   ");
+        host(i).performance.print_json(report, "host", i);
+      }
+      report << "],\n \"devices\": [";
+      for (int i=0; i<num_devices(); i++) {
+        report << (i ? ",\n   " : "\n   ");
+        device(i).performance.print_json(report, "device", i);
+      }
+      report << "]}\n";
+    }
+    else {
+      TileLinkPerformance::print_csv_header(report);
+      for (int i=0; i<num_hosts(); i++)
+        host(i).performance.print_csv(report, "host", i);
+      for (int i=0; i<num_devices(); i++)
+        device(i).performance.print_csv(report, "device", i);
+    }
+
+    MUNTJAC_LOG(1) << "Wrote performance report to " << perf_file << endl;
+  }
+
+  // Detect deadlock (nothing moving while transactions are outstanding) and
+  // livelock (beats moving, but a transaction never completing). Either way,
+  // report the state of every component and abort.
+  void check_progress() const {
+    uint64_t now = (uint64_t)this->simulation_time();
+    bool stuck = false;
+
+    if (max_age > 0) {
+      for (auto host : hosts)
+        stuck |= check_age(host->a, now) | check_age(host->c, now);
+      for (auto device : devices)
+        stuck |= check_age(device->b, now) | check_age(device->d, now);
+    }
+
+    if (watchdog > 0 && !stuck) {
+      uint64_t last_activity = 0;
+      bool busy = false;
+
+      // In a timed replay, the network is idle by design until the next
+      // recorded beat is due, so measure progress from that point.
+      bool waiting = false;
+      if (stimulus.replaying() && !stimulus.fast()) {
+        uint64_t due = replay_next_due();
+        waiting = (due != UINT64_MAX) && (due > stimulus.now());
+        if (due <= stimulus.now())
+          last_activity = now - (stimulus.now() - due);
+      }
+
+      for (auto host : hosts) {
+        last_activity = std::max(last_activity, host->last_activity);
+        busy |= host->busy();
+      }
+      for (auto device : devices) {
+        last_activity = std::max(last_activity, device->last_activity);
+        busy |= device->busy();
+      }
+
+      if (busy && !waiting && now - last_activity >= watchdog) {
+        MUNTJAC_ERROR << "No beats accepted since cycle " << last_activity
+                      << ", but transactions are outstanding" << endl;
+        stuck = true;
+      }
+    }
+
+    if (stuck) {
+      for (auto host : hosts)
+        host->dump_state(cerr);
+      for (auto device : devices)
+        device->dump_state(cerr);
+      abort();
+    }
+  }
+
+  template<class channel>
+  static uint64_t next_due(const TileLinkChannelEnd<channel>& end) {
+    return end.replay.beats.empty() ? UINT64_MAX
+                                    : end.replay.beats.front().first;
+  }
+
+  // Replay: the recorded cycle of the earliest beat still to be sent, or
+  // UINT64_MAX if all have been sent.
+  uint64_t replay_next_due() const {
+    uint64_t due = UINT64_MAX;
+    for (auto host : hosts)
+      due = std::min({due, next_due(host->a), next_due(host->c),
+                      next_due(host->e)});
+    for (auto device : devices)
+      due = std::min({due, next_due(device->b), next_due(device->d)});
+    return due;
+  }
+
+  template<class channel>
+  bool check_age(const TileLinkSender<channel>& sender, uint64_t now) const {
+    int id;
+    uint64_t start;
+    if (!sender.oldest_transaction(id, start) || now - start <= max_age)
+      return false;
+
+    MUNTJAC_ERROR << sender.name() << " transaction ID " << id
+                  << " started on cycle " << start << " and has not completed"
+                  << " after " << max_age << " cycles" << endl;
+    return true;
+  }
+
+  // Summarise the kinds of A request generated by all hosts.
+  void print_coverage_summary() const {
+    int bins_hit = 0, num_bins = 0, ids_hit = 0, num_ids = 0;
+    for (auto host : hosts) {
+      bins_hit += host->coverage.bins_hit();
+      num_bins += host->coverage.num_bins();
+      ids_hit += host->coverage.ids_hit();
+      num_ids += host->coverage.num_ids();
+    }
+
+    cout << "Request coverage: " << bins_hit << "/" << num_bins
+         << " device/opcode/param/size combinations, " << ids_hit << "/"
+         << num_ids << " source IDs" << endl;
+  }
+
+  // Read a recorded trace into the channel ends which will replay it.
+  void load_stimulus() {
+    stimulus.replay(replay_file, num_hosts(), num_devices(), replay_fast);
+
+    bool is_beat, ready;
+    int endpoint, channel;
+    uint64_t cycle;
+
+    while (stimulus.next(is_beat, endpoint, channel, cycle, ready)) {
+      int position = endpoint / 2;
+      bool is_host = (endpoint % 2) == 0;
+
+      if (position >= (is_host ? num_hosts() : num_devices()) || channel > 4) {
+        MUNTJAC_ERROR << replay_file << " contains a record for a component "
+                      << "which doesn't exist" << endl;
+        exit(1);
+      }
+
+      if (is_host) {
+        TileLinkHost& h = host(position);
+        switch (channel) {
+          case 0: load_record(h.a, is_beat, cycle, ready); break;
+          case 1: load_record(h.b, is_beat, cycle, ready); break;
+          case 2: load_record(h.c, is_beat, cycle, ready); break;
+          case 3: load_record(h.d, is_beat, cycle, ready); break;
+          case 4: load_record(h.e, is_beat, cycle, ready); break;
+        }
+      }
+      else {
+        TileLinkDevice& d = device(position);
+        switch (channel) {
+          case 0: load_record(d.a, is_beat, cycle, ready); break;
+          case 1: load_record(d.b, is_beat, cycle, ready); break;
+          case 2: load_record(d.c, is_beat, cycle, ready); break;
+          case 3: load_record(d.d, is_beat, cycle, ready); break;
+          case 4: load_record(d.e, is_beat, cycle, ready); break;
+        }
+      }
+    }
+
+    MUNTJAC_LOG(1) << "Loaded " << stimulus.beats_remaining()
+                   << " beats from " << replay_file << endl;
+  }
+
+  template<class channel>
+  void load_record(TileLinkChannelEnd<channel>& end, bool is_beat,
+                   uint64_t cycle, bool ready) {
+    if (is_beat) {
+      channel beat;
+      stimulus.read_beat(beat);
+      end.replay.beats.push_back({cycle, beat});
+    }
+    else
+      end.replay.ready.push_back({cycle, ready});
+  }
+
+  // Drive the network from the loaded trace until every beat has been sent.
+  // Give up if nothing can be sent for a long time: the network must have
+  // lost or reordered a message that later stimulus depends on.
+  void run_replay() {
+    for (auto host : hosts)
+      host->performance.reset();
+    for (auto device : devices)
+      device->performance.reset();
+
+    const int timeout = 100000;
+    uint64_t remaining = stimulus.beats_remaining();
+    int stalled = 0;
+
+    while (stimulus.beats_remaining() > 0) {
+      next_cycle();
+
+      // Recorded idle periods aren't stalls.
+      if (stimulus.beats_remaining() < remaining ||
+          (!stimulus.fast() && replay_next_due() > stimulus.now())) {
+        remaining = stimulus.beats_remaining();
+        stalled = 0;
+      }
+      else if (++stalled >= timeout) {
+        MUNTJAC_ERROR << "Replay made no progress for " << timeout
+                      << " cycles with " << remaining << " beats left to send"
+                      << endl;
+        abort();
+      }
+    }
+
+    // Allow the final messages to arrive.
+    for (int i=0; i<1000; i++)
+      next_cycle();
+
+    cout << "Replayed " << replay_file << " in " << stimulus.now()
+         << " cycles" << endl;
+
+    if (!perf_file.empty())
+      write_performance_report();
+  }
+
   void list_tests() const {
     for (int i=0; i<tests.size(); i++)
       cout << "\t" << i << "\t" << tests[i].description << endl;
@@ -223,11 +604,37 @@ private:
   // If true, responses will also have random valid content.
   bool randomise;
 
+  // All hosts/devices derive their random streams from this.
+  uint64_t random_seed;
+
   // Configuration of hosts/devices connected to the TileLink network.
   string config_file = "configs/default/config.yaml";
 
+  // Destination of bandwidth/latency statistics, if requested.
+  string perf_file;
+
+  // Check for hangs during random traffic and replay. Directed tests contain
+  // deliberately broken transactions, and have their own timeouts.
+  bool monitor_progress;
+  uint64_t max_age;
+  uint64_t watchdog;
+  static const int check_interval = 256;
+
+  // Cycles between updates to coverage-directed request weights, or 0 for
+  // uniform random requests.
+  uint64_t coverage_interval;
+
+  // Stimulus trace to write, or to read instead of running tests.
+  string record_file;
+  string replay_file;
+  bool replay_fast;
+
   vector<TileLinkHost*> hosts;
   vector<TileLinkDevice*> devices;
+
+  // Hosts/devices supporting at least each protocol.
+  vector<TileLinkHost*> eligible_hosts[TL_C + 1];
+  vector<TileLinkDevice*> eligible_devices[TL_C + 1];
 };
 
 #endif // TL_HARNESS_H
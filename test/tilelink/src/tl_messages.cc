@@ -76,46 +76,59 @@ tl_a new_a_request(TileLinkSender<tl_a>& endpoint, bool randomise) {
 
   if (randomise) {
     auto& host = static_cast<const TileLinkHost&>(endpoint.get_parent());
-    auto& device = the_sim->random_device();
-    tl_protocol_e protocol = max_common_protocol(host.protocol, device.protocol);
 
-    request.opcode = random_a_opcode(protocol);
+    // Coverage-directed requests choose all of these fields together.
+    const tl_a_bin_t* bin = host.coverage.directed() ?
+                            &host.coverage.choose(endpoint.rng) : nullptr;
 
-    switch (request.opcode) {
-      case ArithmeticData:
-        request.param = (int)random_arithmetic_data_param();
-        break;
-      case LogicalData:
-        request.param = (int)random_logical_data_param();
-        break;
-      case Intent:
-        request.param = (int)random_intent_param();
-        break;
-      case AcquireBlock:
-      case AcquirePerm:
-        request.param = (int)random_grow_permission();
-        break;
-      default:
-        request.param = 0;
-        break;
-    }
+    auto& device = bin ? the_sim->device(bin->device)
+                       : the_sim->random_device(endpoint.rng);
+    tl_protocol_e protocol = max_common_protocol(host.protocol, device.protocol);
 
-    request.size = random_sample(0, endpoint.max_size());
-    request.source = endpoint.get_transaction_id(randomise);
+    if (bin) {
+      request.opcode = bin->opcode;
+      request.param = bin->param;
+      request.size = bin->size;
+      request.source = endpoint.get_directed_transaction_id(host.coverage);
+    }
+    else {
+      request.opcode = endpoint.traffic().a_opcode(endpoint.rng, protocol);
+
+      switch (request.opcode) {
+        case ArithmeticData:
+          request.param = (int)random_arithmetic_data_param(endpoint.rng);
+          break;
+        case LogicalData:
+          request.param = (int)random_logical_data_param(endpoint.rng);
+          break;
+        case Intent:
+          request.param = (int)random_intent_param(endpoint.rng);
+          break;
+        case AcquireBlock:
+        case AcquirePerm:
+          request.param = (int)random_grow_permission(endpoint.rng);
+          break;
+        default:
+          request.param = 0;
+          break;
+      }
+
+      request.size = endpoint.traffic().size(endpoint.rng);
+      request.source = endpoint.get_transaction_id(randomise);
+    }
 
-    int raw_address = random_sample(0, 0x1000 - 1);
-    int aligned_address = align(raw_address, 1 << request.size);
-    request.address = get_address(aligned_address, device.position);
+    uint64_t offset = endpoint.traffic().address(endpoint.rng, request.size);
+    request.address = get_address(offset, device.position);
 
     request.mask = complete_mask(request.address, 1 << request.size, endpoint.bit_width() / 8);
     if (request.opcode == PutPartialData)
-      request.mask &= rand();
+      request.mask &= random_int(endpoint.rng);
     
     if (has_payload(request.opcode)) {
-      request.corrupt = random_bool(0.05);
+      request.corrupt = random_bool(endpoint.rng, 0.05);
 
       // A round number in both hex and dec
-      request.data = ((uint64_t)rand() << 32) | align(rand(), 160); 
+      request.data = ((uint64_t)random_int(endpoint.rng) << 32) | align(random_int(endpoint.rng), 160); 
     }
     else
       request.corrupt = false;
@@ -136,14 +149,14 @@ tl_a new_a_request(TileLinkSender<tl_a>& endpoint, bool randomise) {
 
 tl_message<tl_a>::tl_message(TileLinkSender<tl_a>& endpoint,
                              tl_a header, int num_beats) :
-    tl_message_base(endpoint.bit_width() / 8, num_beats, num_beats),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, num_beats, num_beats),
     header(header) {
   // Nothing
 }
 
 tl_message<tl_a>::tl_message(TileLinkSender<tl_a>& endpoint,
-                             bool randomise, map<string, int> requirements) :
-    tl_message_base(endpoint.bit_width() / 8),
+                             bool randomise, const tl_modification& requirements) :
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
     header(modify(new_a_request(endpoint, randomise), requirements)) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   beats_ready = beats_to_send;
@@ -159,10 +172,10 @@ tl_a tl_message<tl_a>::next_beat(bool randomise) {
   if (randomise) {
     if (beat.opcode == PutPartialData)
       beat.mask = complete_mask(beat.address, 1 << beat.size, 
-                                channel_width_bytes) & rand();
+                                channel_width_bytes) & random_int(*rng);
     
     if (has_payload(beat.opcode))
-      beat.corrupt = random_bool(0.05);
+      beat.corrupt = random_bool(*rng, 0.05);
   }
 
   beats_generated++;
@@ -170,23 +183,26 @@ tl_a tl_message<tl_a>::next_beat(bool randomise) {
   return beat;
 }
 
-tl_a tl_message<tl_a>::modify(tl_a beat, map<string, int>& updates) {
-  if (updates.find("opcode") != updates.end())
-    beat.opcode = (tl_a_op_e)updates["opcode"];
-  if (updates.find("param") != updates.end())
-    beat.param = updates["param"];
-  if (updates.find("size") != updates.end())
-    beat.size = updates["size"];
-  if (updates.find("source") != updates.end())
-    beat.source = updates["source"];
-  if (updates.find("address") != updates.end())
-    beat.address = updates["address"];
-  if (updates.find("mask") != updates.end())
-    beat.mask = updates["mask"];
-  if (updates.find("corrupt") != updates.end())
-    beat.corrupt = updates["corrupt"];
-  if (updates.find("data") != updates.end())
-    beat.data = updates["data"];
+tl_a tl_message<tl_a>::modify(tl_a beat, const tl_modification& updates) {
+  if (updates.empty())
+    return beat;
+
+  if (updates.has(TL_OPCODE))
+    beat.opcode = (tl_a_op_e)updates.get(TL_OPCODE);
+  if (updates.has(TL_PARAM))
+    beat.param = updates.get(TL_PARAM);
+  if (updates.has(TL_SIZE))
+    beat.size = updates.get(TL_SIZE);
+  if (updates.has(TL_SOURCE))
+    beat.source = updates.get(TL_SOURCE);
+  if (updates.has(TL_ADDRESS))
+    beat.address = updates.get(TL_ADDRESS);
+  if (updates.has(TL_MASK))
+    beat.mask = updates.get(TL_MASK);
+  if (updates.has(TL_CORRUPT))
+    beat.corrupt = updates.get(TL_CORRUPT);
+  if (updates.has(TL_DATA))
+    beat.data = updates.get(TL_DATA);
   
   return beat;
 }
@@ -217,22 +233,21 @@ int num_beats(tl_b_op_e opcode, int size, int channel_width_bytes) {
 tl_b new_b_request(TileLinkSender<tl_b>& endpoint, bool randomise) {
   tl_b request;
 
-  auto& host = the_sim->random_host(TL_C);
+  auto& host = the_sim->random_host(endpoint.rng, TL_C);
   auto& device = static_cast<const TileLinkDevice&>(endpoint.get_parent());
 
   if (randomise) {
-    request.opcode = random_b_opcode(device.protocol);
-    request.param = random_cap_permission();
-    request.size = random_sample(0, endpoint.max_size());
+    request.opcode = random_b_opcode(endpoint.rng, device.protocol);
+    request.param = random_cap_permission(endpoint.rng);
+    request.size = endpoint.traffic().size(endpoint.rng);
     request.source = device.get_routing_id(host.position);
 
     // Can't use an address/source combination that's already in use, so
     // generate new addresses until an unused one is found.
     // Assumes an unused address/source combination exists.
     while (true) {
-      int raw_address = random_sample(0, 0x1000 - 1);
-      int device_address = get_address(raw_address, device.position);
-      request.address = align(device_address, 1 << request.size);
+      uint64_t offset = endpoint.traffic().address(endpoint.rng, request.size);
+      request.address = get_address(offset, device.position);
       int id = device.get_b_id(request.source, request.address);
 
       if (endpoint.transaction_id_available(id))
@@ -260,14 +275,14 @@ tl_b new_b_request(TileLinkSender<tl_b>& endpoint, bool randomise) {
 
 tl_message<tl_b>::tl_message(TileLinkSender<tl_b>& endpoint,
                              tl_b header, int num_beats) :
-    tl_message_base(endpoint.bit_width() / 8, num_beats, num_beats),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, num_beats, num_beats),
     header(header) {
   // Nothing
 }
 
 tl_message<tl_b>::tl_message(TileLinkSender<tl_b>& endpoint,
-                             bool randomise, map<string, int> requirements) :
-    tl_message_base(endpoint.bit_width() / 8),
+                             bool randomise, const tl_modification& requirements) :
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
     header(modify(new_b_request(endpoint, randomise), requirements)) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   beats_ready = beats_to_send;
@@ -289,8 +304,8 @@ tl_b new_b_response(TileLinkSender<tl_b>& endpoint, tl_a& request,
   response.address = request.address;
 
   if (randomise) {
-    response.param = random_cap_permission();
-    response.source = rand();
+    response.param = random_cap_permission(endpoint.rng);
+    response.source = random_int(endpoint.rng);
   }
   else {
     response.param = 0;
@@ -303,7 +318,7 @@ tl_b new_b_response(TileLinkSender<tl_b>& endpoint, tl_a& request,
 tl_message<tl_b>::tl_message(TileLinkSender<tl_b>& endpoint, tl_a& request,
                              bool randomise) :
     header(new_b_response(endpoint, request, randomise)),
-    tl_message_base(endpoint.bit_width() / 8,
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8,
                     num_beats(header.opcode, header.size, endpoint.bit_width() / 8),
                     num_beats(header.opcode, header.size, endpoint.bit_width() / 8)) {
   // Nothing
@@ -316,17 +331,20 @@ tl_b tl_message<tl_b>::next_beat(bool randomise) {
   return header;
 }
 
-tl_b tl_message<tl_b>::modify(tl_b beat, map<string, int>& updates) {
-  if (updates.find("opcode") != updates.end())
-    beat.opcode = (tl_b_op_e)updates["opcode"];
-  if (updates.find("param") != updates.end())
-    beat.param = updates["param"];
-  if (updates.find("size") != updates.end())
-    beat.size = updates["size"];
-  if (updates.find("source") != updates.end())
-    beat.source = updates["source"];
-  if (updates.find("address") != updates.end())
-    beat.address = updates["address"];
+tl_b tl_message<tl_b>::modify(tl_b beat, const tl_modification& updates) {
+  if (updates.empty())
+    return beat;
+
+  if (updates.has(TL_OPCODE))
+    beat.opcode = (tl_b_op_e)updates.get(TL_OPCODE);
+  if (updates.has(TL_PARAM))
+    beat.param = updates.get(TL_PARAM);
+  if (updates.has(TL_SIZE))
+    beat.size = updates.get(TL_SIZE);
+  if (updates.has(TL_SOURCE))
+    beat.source = updates.get(TL_SOURCE);
+  if (updates.has(TL_ADDRESS))
+    beat.address = updates.get(TL_ADDRESS);
   
   return beat;
 }
@@ -357,25 +375,24 @@ tl_c new_c_request(TileLinkSender<tl_c>& endpoint, bool randomise) {
 
   if (randomise) {
     auto& host = static_cast<const TileLinkHost&>(endpoint.get_parent());
-    auto& device = the_sim->random_device(TL_C_IO_TERM);
+    auto& device = the_sim->random_device(endpoint.rng, TL_C_IO_TERM);
     tl_protocol_e protocol = host.protocol;
 
-    request.opcode = random_c_opcode(protocol);
-    request.param = random_bool() ? (int)random_prune_permission()
-                                  : (int)random_report_permission();
+    request.opcode = random_c_opcode(endpoint.rng, protocol);
+    request.param = random_bool(endpoint.rng) ? (int)random_prune_permission(endpoint.rng)
+                                  : (int)random_report_permission(endpoint.rng);
 
-    request.size = random_sample(0, endpoint.max_size());
+    request.size = endpoint.traffic().size(endpoint.rng);
     request.source = endpoint.get_transaction_id(randomise);
 
-    int raw_address = random_sample(0, 0x1000 - 1);
-    int aligned_address = align(raw_address, 1 << request.size);
-    request.address = get_address(aligned_address, device.position);
+    uint64_t offset = endpoint.traffic().address(endpoint.rng, request.size);
+    request.address = get_address(offset, device.position);
     
     if (has_payload(request.opcode)) {
-      request.corrupt = random_bool(0.05);
+      request.corrupt = random_bool(endpoint.rng, 0.05);
 
       // A round number in both hex and dec
-      request.data = ((uint64_t)rand() << 32) | align(rand(), 160);
+      request.data = ((uint64_t)random_int(endpoint.rng) << 32) | align(random_int(endpoint.rng), 160);
     }
     else
       request.corrupt = false;
@@ -395,14 +412,14 @@ tl_c new_c_request(TileLinkSender<tl_c>& endpoint, bool randomise) {
 
 tl_message<tl_c>::tl_message(TileLinkSender<tl_c>& endpoint,
                              tl_c header, int num_beats) :
-    tl_message_base(endpoint.bit_width() / 8, num_beats, num_beats),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, num_beats, num_beats),
     header(header) {
   // Nothing
 }
 
 tl_message<tl_c>::tl_message(TileLinkSender<tl_c>& endpoint,
-                             bool randomise, map<string, int> requirements) :
-    tl_message_base(endpoint.bit_width() / 8),
+                             bool randomise, const tl_modification& requirements) :
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
     header(modify(new_c_request(endpoint, randomise), requirements)) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   beats_ready = beats_to_send;
@@ -429,18 +446,18 @@ tl_c new_c_response(TileLinkSender<tl_c>& endpoint, tl_b& request,
 
   if (randomise) {
     // 20% chance of writing back data.
-    if (request.opcode == ProbeBlock && random_bool(0.2))
+    if (request.opcode == ProbeBlock && random_bool(endpoint.rng, 0.2))
       response.opcode = ProbeAckData;
 
     // Note: not checking that this matches the request.
-    response.param = random_bool() ? (int)random_prune_permission()
-                                   : (int)random_report_permission();
+    response.param = random_bool(endpoint.rng) ? (int)random_prune_permission(endpoint.rng)
+                                   : (int)random_report_permission(endpoint.rng);
     
     if (has_payload(response.opcode)) {
-      response.corrupt = random_bool(0.05);
+      response.corrupt = random_bool(endpoint.rng, 0.05);
 
       // A round number in both hex and dec
-      response.data = ((uint64_t)rand() << 32) | align(rand(), 160); 
+      response.data = ((uint64_t)random_int(endpoint.rng) << 32) | align(random_int(endpoint.rng), 160); 
     }
     else
       response.corrupt = false;
@@ -456,7 +473,7 @@ tl_c new_c_response(TileLinkSender<tl_c>& endpoint, tl_b& request,
 
 tl_message<tl_c>::tl_message(TileLinkSender<tl_c>& endpoint, tl_b& request,
                              bool randomise) :
-    tl_message_base(endpoint.bit_width() / 8),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
     header(new_c_response(endpoint, request, randomise)) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   beats_ready = beats_to_send;
@@ -471,7 +488,7 @@ tl_c tl_message<tl_c>::next_beat(bool randomise) {
 
   if (randomise) {
     if (has_payload(beat.opcode))
-      beat.corrupt = random_bool(0.05);
+      beat.corrupt = random_bool(*rng, 0.05);
   }
 
   beats_generated++;
@@ -479,21 +496,24 @@ tl_c tl_message<tl_c>::next_beat(bool randomise) {
   return beat;
 }
 
-tl_c tl_message<tl_c>::modify(tl_c beat, map<string, int>& updates) {
-  if (updates.find("opcode") != updates.end())
-    beat.opcode = (tl_c_op_e)updates["opcode"];
-  if (updates.find("param") != updates.end())
-    beat.param = updates["param"];
-  if (updates.find("size") != updates.end())
-    beat.size = updates["size"];
-  if (updates.find("source") != updates.end())
-    beat.source = updates["source"];
-  if (updates.find("address") != updates.end())
-    beat.address = updates["address"];
-  if (updates.find("corrupt") != updates.end())
-    beat.corrupt = updates["corrupt"];
-  if (updates.find("data") != updates.end())
-    beat.data = updates["data"];
+tl_c tl_message<tl_c>::modify(tl_c beat, const tl_modification& updates) {
+  if (updates.empty())
+    return beat;
+
+  if (updates.has(TL_OPCODE))
+    beat.opcode = (tl_c_op_e)updates.get(TL_OPCODE);
+  if (updates.has(TL_PARAM))
+    beat.param = updates.get(TL_PARAM);
+  if (updates.has(TL_SIZE))
+    beat.size = updates.get(TL_SIZE);
+  if (updates.has(TL_SOURCE))
+    beat.source = updates.get(TL_SOURCE);
+  if (updates.has(TL_ADDRESS))
+    beat.address = updates.get(TL_ADDRESS);
+  if (updates.has(TL_CORRUPT))
+    beat.corrupt = updates.get(TL_CORRUPT);
+  if (updates.has(TL_DATA))
+    beat.data = updates.get(TL_DATA);
   
   return beat;
 }
@@ -544,23 +564,23 @@ tl_d new_d_response(TileLinkSender<tl_d>& endpoint, tl_a& request,
 
   if (randomise) {
     // Should be deterministic based on request.param, but randomising for now.
-    if (request.opcode == AcquireBlock && random_bool(0.2))
+    if (request.opcode == AcquireBlock && random_bool(endpoint.rng, 0.2))
       response.opcode = GrantData;
     
     switch (response.opcode) {
       case Grant:
       case GrantData:
-        response.param = (int)random_cap_permission(); break;
+        response.param = (int)random_cap_permission(endpoint.rng); break;
 
       default:
         response.param = 0; break;
     }
-    response.denied = endpoint.can_deny() && random_bool(0.1);
+    response.denied = endpoint.can_deny() && random_bool(endpoint.rng, 0.1);
     response.corrupt = 
-      has_payload(response.opcode) ? (response.denied || random_bool(0.1)) : 0;
+      has_payload(response.opcode) ? (response.denied || random_bool(endpoint.rng, 0.1)) : 0;
 
     // A round number in both hex and dec
-    response.data = ((uint64_t)rand() << 32) | align(rand(), 160); 
+    response.data = ((uint64_t)random_int(endpoint.rng) << 32) | align(random_int(endpoint.rng), 160); 
   }
   else {
     response.param = 0;
@@ -574,15 +594,17 @@ tl_d new_d_response(TileLinkSender<tl_d>& endpoint, tl_a& request,
 
 tl_message<tl_d>::tl_message(TileLinkSender<tl_d>& endpoint,
                              tl_d header, int num_beats) :
-    tl_message_base(endpoint.bit_width() / 8, num_beats, num_beats),
-    header(header) {
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, num_beats, num_beats),
+    header(header),
+    request_address(0) {
   // Nothing
 }
 
 tl_message<tl_d>::tl_message(TileLinkSender<tl_d>& endpoint, tl_a& request,
                              bool randomise) :
-    tl_message_base(endpoint.bit_width() / 8),
-    header(new_d_response(endpoint, request, randomise)) {
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
+    header(new_d_response(endpoint, request, randomise)),
+    request_address(request.address) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   
   // LogicalData and ArithmeticData have multibeat requests and responses. We
@@ -593,6 +615,19 @@ tl_message<tl_d>::tl_message(TileLinkSender<tl_d>& endpoint, tl_a& request,
     beats_ready = beats_to_send;
 
   assert(beats_to_send > 0);
+
+  // Random traffic is served from the device's reference memory, so the
+  // scoreboard can follow the data.
+  if (randomise && has_payload(header.opcode)) {
+    auto& memory = the_sim->scoreboard.memory(endpoint.position());
+
+    if (request.opcode == LogicalData || request.opcode == ArithmeticData)
+      payload.push_back(memory.atomic(request, 0, channel_width_bytes));
+    else
+      for (int beat=0; beat<beats_to_send; beat++)
+        payload.push_back(memory.read(request.address, header.size, beat,
+                                      channel_width_bytes));
+  }
 }
 
 tl_d new_d_response(TileLinkSender<tl_d>& endpoint, tl_c& request,
@@ -623,8 +658,9 @@ tl_d new_d_response(TileLinkSender<tl_d>& endpoint, tl_c& request,
 
 tl_message<tl_d>::tl_message(TileLinkSender<tl_d>& endpoint, tl_c& request,
                              bool randomise) :
-    tl_message_base(endpoint.bit_width() / 8),
-    header(new_d_response(endpoint, request, randomise)) {
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8),
+    header(new_d_response(endpoint, request, randomise)),
+    request_address(0) {
   beats_to_send = num_beats(header.opcode, header.size, endpoint.bit_width() / 8);
   beats_ready = beats_to_send;
   assert(beats_to_send > 0);
@@ -633,35 +669,42 @@ tl_message<tl_d>::tl_message(TileLinkSender<tl_d>& endpoint, tl_c& request,
 tl_d tl_message<tl_d>::next_beat(bool randomise) {
   tl_d beat = header;
 
-  // Make it obvious which beat this is - for debugging.
-  beat.data += beats_generated;
+  // Use real data if we have it. Otherwise make it obvious which beat this
+  // is - for debugging.
+  if ((size_t)beats_generated < payload.size())
+    beat.data = payload[beats_generated];
+  else
+    beat.data += beats_generated;
 
   if (randomise)
     if (has_payload(beat.opcode))
-      beat.corrupt = beat.denied || random_bool(0.05);
+      beat.corrupt = beat.denied || random_bool(*rng, 0.05);
 
   beats_generated++;
 
   return beat;
 }
 
-tl_d tl_message<tl_d>::modify(tl_d beat, map<string, int>& updates) {
-  if (updates.find("opcode") != updates.end())
-    beat.opcode = (tl_d_op_e)updates["opcode"];
-  if (updates.find("param") != updates.end())
-    beat.param = updates["param"];
-  if (updates.find("size") != updates.end())
-    beat.size = updates["size"];
-  if (updates.find("source") != updates.end())
-    beat.source = updates["source"];
-  if (updates.find("sink") != updates.end())
-    beat.sink = updates["sink"];
-  if (updates.find("denied") != updates.end())
-    beat.denied = updates["denied"];
-  if (updates.find("corrupt") != updates.end())
-    beat.corrupt = updates["corrupt"];
-  if (updates.find("data") != updates.end())
-    beat.data = updates["data"];
+tl_d tl_message<tl_d>::modify(tl_d beat, const tl_modification& updates) {
+  if (updates.empty())
+    return beat;
+
+  if (updates.has(TL_OPCODE))
+    beat.opcode = (tl_d_op_e)updates.get(TL_OPCODE);
+  if (updates.has(TL_PARAM))
+    beat.param = updates.get(TL_PARAM);
+  if (updates.has(TL_SIZE))
+    beat.size = updates.get(TL_SIZE);
+  if (updates.has(TL_SOURCE))
+    beat.source = updates.get(TL_SOURCE);
+  if (updates.has(TL_SINK))
+    beat.sink = updates.get(TL_SINK);
+  if (updates.has(TL_DENIED))
+    beat.denied = updates.get(TL_DENIED);
+  if (updates.has(TL_CORRUPT))
+    beat.corrupt = updates.get(TL_CORRUPT);
+  if (updates.has(TL_DATA))
+    beat.data = updates.get(TL_DATA);
 
   return beat;
 }
@@ -680,14 +723,14 @@ tl_e new_e_response(TileLinkSender<tl_e>& endpoint, tl_d& request,
 
 tl_message<tl_e>::tl_message(TileLinkSender<tl_e>& endpoint,
                              tl_e header, int num_beats) :
-    tl_message_base(endpoint.bit_width() / 8, num_beats, num_beats),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, num_beats, num_beats),
     header(header) {
   // Nothing
 }
 
 tl_message<tl_e>::tl_message(TileLinkSender<tl_e>& endpoint, tl_d& request,
                              bool randomise) :
-    tl_message_base(endpoint.bit_width() / 8, 1, 1),
+    tl_message_base(endpoint.rng, endpoint.bit_width() / 8, 1, 1),
     header(new_e_response(endpoint, request, randomise)) {
   // Nothing
 }
@@ -699,9 +742,12 @@ tl_e tl_message<tl_e>::next_beat(bool randomise) {
   return header;
 }
 
-tl_e tl_message<tl_e>::modify(tl_e beat, map<string, int>& updates) {
-  if (updates.find("sink") != updates.end())
-    beat.sink = updates["sink"];
+tl_e tl_message<tl_e>::modify(tl_e beat, const tl_modification& updates) {
+  if (updates.empty())
+    return beat;
+
+  if (updates.has(TL_SINK))
+    beat.sink = updates.get(TL_SINK);
   
   return beat;
 }
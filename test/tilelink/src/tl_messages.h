@@ -6,15 +6,65 @@
 #define TL_MESSAGES_H
 
 #include <cassert>
-#include <map>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
 
 #include "tilelink.h"
+#include "tl_random.h"
 
-using std::map;
-using std::string;
+using std::vector;
 
 template<typename channel_t> class TileLinkSender;
 
+// Message fields which can be overridden, plus a couple of pseudo-fields which
+// control how a sender emits a beat.
+typedef enum {
+  TL_OPCODE,
+  TL_PARAM,
+  TL_SIZE,
+  TL_SOURCE,
+  TL_SINK,
+  TL_ADDRESS,
+  TL_MASK,
+  TL_DENIED,
+  TL_CORRUPT,
+  TL_DATA,
+
+  TL_DUPLICATE_BEAT,  // Send this beat again afterwards
+  TL_DROP_BEAT,       // Don't send this beat
+
+  TL_NUM_FIELDS
+} tl_field_e;
+
+// A set of changes to apply to a message, e.g. {{TL_SIZE, 4}}. Fields which
+// don't exist on a particular channel are ignored.
+class tl_modification {
+public:
+  tl_modification() : fields(0) {}
+
+  tl_modification(std::initializer_list<std::pair<tl_field_e, uint64_t>> updates) :
+      fields(0) {
+    for (auto& update : updates)
+      set(update.first, update.second);
+  }
+
+  bool empty() const                {return fields == 0;}
+  bool has(tl_field_e field) const  {return fields & (1u << field);}
+  uint64_t get(tl_field_e field) const {return values[field];}
+
+  void set(tl_field_e field, uint64_t value) {
+    fields |= 1u << field;
+    values[field] = value;
+  }
+
+private:
+  // Bitmask of fields present. Values of absent fields are uninitialised.
+  uint32_t fields;
+  uint64_t values[TL_NUM_FIELDS];
+};
+
 // A "message" in TileLink terms is a sequence of beats which are all part of
 // the same request/response.
 class tl_message_base {
@@ -22,7 +72,8 @@ public:
 
   // Basic constructor for when we don't yet know how many beats this message
   // will require. `beats_to_send` and `beats_ready` must be set separately.
-  tl_message_base(int channel_width_bytes) :
+  tl_message_base(TileLinkRandom& rng, int channel_width_bytes) :
+      rng(&rng),
       channel_width_bytes(channel_width_bytes) {
     assert(channel_width_bytes > 0);
 
@@ -32,7 +83,9 @@ public:
   // Create a message from given control signals.
   // Use `num_beats` to control how many beats are generated automatically 
   // (i.e. have dummy payloads).
-  tl_message_base(int channel_width_bytes, int num_beats, int beats_ready) :
+  tl_message_base(TileLinkRandom& rng, int channel_width_bytes, int num_beats,
+                  int beats_ready) :
+      rng(&rng),
       channel_width_bytes(channel_width_bytes),
       beats_to_send(num_beats),
       beats_ready(beats_ready) {
@@ -82,6 +135,10 @@ public:
 
 protected:
 
+  // Random stream of the channel this message is being sent on, used when
+  // randomising later beats.
+  TileLinkRandom* rng;
+
   // The width of the channel this message is being sent on.
   const int channel_width_bytes;
 
@@ -118,16 +175,15 @@ public:
   tl_message(source_t& endpoint, channel_t header, int num_beats);
 
   // New (random) A request.
-  // `requirements` maps TileLink field names to values, e.g. {{"size", 4}}.
+  // `requirements` forces fields to particular values, e.g. {{TL_SIZE, 4}}.
   tl_message(source_t& endpoint, bool randomise,
-             map<string, int> requirements = map<string, int>());
+             const tl_modification& requirements = tl_modification());
 
   // Get the next beat of a message.
   channel_t next_beat(bool randomise);
 
   // Modify a beat of a message.
-  // `updates` maps TileLink field names to values, e.g. {{"size", 4}}.
-  static channel_t modify(channel_t beat, map<string, int>& updates);
+  static channel_t modify(channel_t beat, const tl_modification& updates);
 
   // First beat of the message, containing all control signals.
   channel_t header;
@@ -144,9 +200,9 @@ public:
   tl_message(source_t& endpoint, channel_t header, int num_beats);
 
   // New (random) B request.
-  // `requirements` maps TileLink field names to values, e.g. {{"size", 4}}.
+  // `requirements` forces fields to particular values, e.g. {{TL_SIZE, 4}}.
   tl_message(source_t& endpoint, bool randomise,
-             map<string, int> requirements = map<string, int>());
+             const tl_modification& requirements = tl_modification());
 
   // B response to A request.
   tl_message(source_t& endpoint, tl_a& request, bool randomise);
@@ -155,8 +211,7 @@ public:
   channel_t next_beat(bool randomise);
 
   // Modify a beat of a message.
-  // `updates` maps TileLink field names to values, e.g. {{"size", 4}}.
-  static channel_t modify(channel_t beat, map<string, int>& updates);
+  static channel_t modify(channel_t beat, const tl_modification& updates);
 
   // First beat of the message, containing all control signals.
   channel_t header;
@@ -173,9 +228,9 @@ public:
   tl_message(source_t& endpoint, channel_t header, int num_beats);
 
   // New (random) C request.
-  // `requirements` maps TileLink field names to values, e.g. {{"size", 4}}.
+  // `requirements` forces fields to particular values, e.g. {{TL_SIZE, 4}}.
   tl_message(source_t& endpoint, bool randomise,
-             map<string, int> requirements = map<string, int>());
+             const tl_modification& requirements = tl_modification());
 
   // C response to B request.
   tl_message(source_t& endpoint, tl_b& request, bool randomise);
@@ -184,8 +239,7 @@ public:
   channel_t next_beat(bool randomise);
 
   // Modify a beat of a message.
-  // `updates` maps TileLink field names to values, e.g. {{"size", 4}}.
-  static channel_t modify(channel_t beat, map<string, int>& updates);
+  static channel_t modify(channel_t beat, const tl_modification& updates);
 
   // First beat of the message, containing all control signals.
   channel_t header;
@@ -211,11 +265,17 @@ public:
   channel_t next_beat(bool randomise);
 
   // Modify a beat of a message.
-  // `updates` maps TileLink field names to values, e.g. {{"size", 4}}.
-  static channel_t modify(channel_t beat, map<string, int>& updates);
+  static channel_t modify(channel_t beat, const tl_modification& updates);
 
   // First beat of the message, containing all control signals.
   channel_t header;
+
+  // Address of the A request being responded to, if any.
+  uint64_t request_address;
+
+  // Data for each beat, read from the device's reference memory. Empty if the
+  // data is a dummy value.
+  vector<uint64_t> payload;
 };
 
 template<>
@@ -235,8 +295,7 @@ public:
   channel_t next_beat(bool randomise);
 
   // Modify a beat of a message.
-  // `updates` maps TileLink field names to values, e.g. {{"size", 4}}.
-  static channel_t modify(channel_t beat, map<string, int>& updates);
+  static channel_t modify(channel_t beat, const tl_modification& updates);
 
   // First beat of the message, containing all control signals.
   channel_t header;
@@ -0,0 +1,136 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <iomanip>
+
+#include "tl_performance.h"
+
+TileLinkPerformance::TileLinkPerformance(int first_id, int last_id) :
+    first_id(first_id),
+    num_ids(last_id - first_id + 1) {
+  start_cycle.resize(2 * num_ids);
+  reset();
+}
+
+void TileLinkPerformance::reset() {
+  cycles = 0;
+  for (int i=0; i<5; i++)
+    beats[i] = 0;
+
+  for (auto& start : start_cycle)
+    start = NOT_STARTED;
+  outstanding = 0;
+
+  completed = 0;
+  total_latency = 0;
+  latencies.clear();
+  occupancy.clear();
+}
+
+int TileLinkPerformance::slot(int channel, int source) const {
+  int id = source - first_id;
+  if (id < 0 || id >= num_ids)
+    return -1;
+
+  // A and C requests may use the same source IDs.
+  return (channel == channel_index<tl_c>()) ? num_ids + id : id;
+}
+
+void TileLinkPerformance::request_started(int channel, int source) {
+  int index = slot(channel, source);
+  if (index < 0)
+    return;
+
+  if (start_cycle[index] == NOT_STARTED)
+    outstanding++;
+  start_cycle[index] = cycles;
+}
+
+void TileLinkPerformance::request_finished(int channel, int source) {
+  int index = slot(channel, source);
+
+  // Ignore transactions which began before measurement started.
+  if (index < 0 || start_cycle[index] == NOT_STARTED)
+    return;
+
+  uint64_t latency = cycles - start_cycle[index];
+  start_cycle[index] = NOT_STARTED;
+  outstanding--;
+
+  completed++;
+  total_latency += latency;
+  if (latency >= latencies.size())
+    latencies.resize(latency + 1, 0);
+  latencies[latency]++;
+}
+
+uint64_t TileLinkPerformance::latency_percentile(double fraction) const {
+  uint64_t target = (uint64_t)(fraction * completed + 0.5);
+  uint64_t seen = 0;
+
+  for (uint64_t latency=0; latency<latencies.size(); latency++) {
+    seen += latencies[latency];
+    if (seen >= target && seen > 0)
+      return latency;
+  }
+
+  return 0;
+}
+
+void TileLinkPerformance::print_csv_header(std::ostream& os) {
+  os << "endpoint,position,cycles,"
+     << "a_beats_per_cycle,b_beats_per_cycle,c_beats_per_cycle,"
+     << "d_beats_per_cycle,e_beats_per_cycle,transactions,"
+     << "latency_mean,latency_p50,latency_p90,latency_p99,latency_max,"
+     << "occupancy_mean,occupancy_max\n";
+}
+
+static double ratio(uint64_t numerator, uint64_t denominator) {
+  return (denominator == 0) ? 0.0 : (double)numerator / denominator;
+}
+
+void TileLinkPerformance::print_csv(std::ostream& os, const string& type,
+                                    int position) const {
+  os << type << "," << position << "," << cycles << ",";
+  os << std::fixed << std::setprecision(4);
+  for (int i=0; i<5; i++)
+    os << ratio(beats[i], cycles) << ",";
+
+  uint64_t occupancy_total = 0;
+  for (uint64_t i=0; i<occupancy.size(); i++)
+    occupancy_total += i * occupancy[i];
+
+  os << completed << ","
+     << std::setprecision(2) << ratio(total_latency, completed) << ","
+     << latency_percentile(0.5) << "," << latency_percentile(0.9) << ","
+     << latency_percentile(0.99) << ","
+     << (latencies.empty() ? 0 : latencies.size() - 1) << ","
+     << ratio(occupancy_total, cycles) << ","
+     << (occupancy.empty() ? 0 : occupancy.size() - 1) << "\n";
+}
+
+void TileLinkPerformance::print_json(std::ostream& os, const string& type,
+                                     int position) const {
+  static const char* channels = "abcde";
+
+  uint64_t occupancy_total = 0;
+  for (uint64_t i=0; i<occupancy.size(); i++)
+    occupancy_total += i * occupancy[i];
+
+  os << std::fixed << std::setprecision(4);
+  os << "{\"endpoint\": \"" << type << "\", \"position\": " << position
+     << ", \"cycles\": " << cycles << ", \"beats_per_cycle\": {";
+  for (int i=0; i<5; i++)
+    os << (i ? ", " : "") << "\"" << channels[i] << "\": " << ratio(beats[i], cycles);
+  os << "}, \"transactions\": " << completed
+     << ", \"latency\": {\"mean\": " << std::setprecision(2)
+     << ratio(total_latency, completed)
+     << ", \"p50\": " << latency_percentile(0.5)
+     << ", \"p90\": " << latency_percentile(0.9)
+     << ", \"p99\": " << latency_percentile(0.99)
+     << ", \"max\": " << (latencies.empty() ? 0 : latencies.size() - 1)
+     << "}, \"occupancy\": {\"mean\": " << ratio(occupancy_total, cycles)
+     << ", \"max\": " << (occupancy.empty() ? 0 : occupancy.size() - 1)
+     << "}}";
+}
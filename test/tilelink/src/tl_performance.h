@@ -0,0 +1,94 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TL_PERFORMANCE_H
+#define TL_PERFORMANCE_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tilelink.h"
+
+using std::string;
+using std::vector;
+
+// Index of each channel in per-channel statistics.
+template<typename channel> int channel_index();
+template<> inline int channel_index<tl_a>() {return 0;}
+template<> inline int channel_index<tl_b>() {return 1;}
+template<> inline int channel_index<tl_c>() {return 2;}
+template<> inline int channel_index<tl_d>() {return 3;}
+template<> inline int channel_index<tl_e>() {return 4;}
+
+// Throughput, latency and occupancy measurements for one host/device.
+//
+// Every beat accepted on each channel is counted. For hosts, each A or C
+// request is also timestamped when its first beat enters the network, and the
+// transaction is complete when the final beat of the D response arrives.
+// Transactions are keyed by channel and source ID, so lookups are O(1).
+class TileLinkPerformance {
+public:
+  TileLinkPerformance(int first_id, int last_id);
+
+  // Discard all statistics and start measuring from now.
+  void reset();
+
+  // Advance one clock cycle.
+  void tick() {
+    cycles++;
+
+    if ((size_t)outstanding >= occupancy.size())
+      occupancy.resize(outstanding + 1, 0);
+    occupancy[outstanding]++;
+  }
+
+  void beat_accepted(int channel) {
+    beats[channel]++;
+  }
+
+  // `channel` is the request channel: A or C.
+  void request_started(int channel, int source);
+  void request_finished(int channel, int source);
+
+  uint64_t measured_cycles() const {return cycles;}
+
+  // Output one CSV row or JSON object. Headers/brackets are the caller's
+  // responsibility.
+  static void print_csv_header(std::ostream& os);
+  void print_csv(std::ostream& os, const string& type, int position) const;
+  void print_json(std::ostream& os, const string& type, int position) const;
+
+private:
+
+  // Smallest latency such that `fraction` of transactions were no slower.
+  uint64_t latency_percentile(double fraction) const;
+
+  // Index into `start_cycle` for a given request, or -1 if untracked.
+  int slot(int channel, int source) const;
+
+  static const uint64_t NOT_STARTED = UINT64_MAX;
+
+  const int first_id;
+  const int num_ids;
+
+  uint64_t cycles;
+  uint64_t beats[5];
+
+  // Cycle on which each outstanding request was injected, indexed by slot.
+  vector<uint64_t> start_cycle;
+  int outstanding;
+
+  uint64_t completed;
+  uint64_t total_latency;
+
+  // Number of transactions which took each number of cycles.
+  vector<uint64_t> latencies;
+
+  // Number of cycles with each number of outstanding transactions.
+  vector<uint64_t> occupancy;
+};
+
+#endif // TL_PERFORMANCE_H
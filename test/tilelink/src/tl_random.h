@@ -6,24 +6,96 @@
 #define TL_RANDOM_H
 
 #include <cassert>
-#include <cstdlib>
+#include <cstdint>
 #include <vector>
 
 #include "tilelink.h"
 
 using std::vector;
 
+// A stream of pseudo-random numbers (xoshiro256**). Each host/device, and
+// each end of each channel, owns its own stream, derived from the global seed
+// and the component's position. Traffic from one component is therefore
+// reproducible even if other components are added or removed, or consume a
+// different amount of randomness.
+class TileLinkRandom {
+public:
+  TileLinkRandom() {
+    seed(0, 0);
+  }
+
+  // Initialise stream number `stream` of the given seed. All streams of all
+  // seeds are independent.
+  void seed(uint64_t seed, uint64_t stream) {
+    uint64_t x = splitmix64(seed) ^ (stream * 0x9E3779B97F4A7C15ULL);
+    for (int i=0; i<4; i++)
+      state[i] = splitmix64(x);
+  }
+
+  uint64_t next() {
+    uint64_t result = rotl(state[1] * 5, 7) * 9;
+    uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+  }
+
+  // Uniform in [0, range), without modulo bias (Lemire's method).
+  uint64_t below(uint64_t range) {
+    assert(range > 0);
+    __uint128_t product = (__uint128_t)next() * range;
+    uint64_t low = (uint64_t)product;
+
+    if (low < range) {
+      uint64_t threshold = -range % range;
+      while (low < threshold) {
+        product = (__uint128_t)next() * range;
+        low = (uint64_t)product;
+      }
+    }
+
+    return product >> 64;
+  }
+
+private:
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  // Advances `x` and returns a well-mixed function of it.
+  static uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t state[4];
+};
+
 // Both min and max are inclusive.
-static int random_sample(int min, int max) {
-  return min + (rand() % (max - min + 1));
+static int random_sample(TileLinkRandom& rng, int min, int max) {
+  return min + (int)rng.below((uint64_t)(max - min) + 1);
 }
 
-static bool random_bool(float prob_true = 0.5) {
-  return (rand() % 1000) < (1000 * prob_true);
+static bool random_bool(TileLinkRandom& rng, float prob_true = 0.5) {
+  // Top 24 bits: exact for any float probability.
+  return (rng.next() >> 40) < (uint64_t)(prob_true * (1 << 24));
 }
 
+// A non-negative 31-bit value, for fields which don't need a particular range.
+static int random_int(TileLinkRandom& rng) {
+  return rng.next() >> 33;
+}
 
-static tl_a_op_e random_a_opcode(tl_protocol_e protocol) {
+// A opcodes supported by each protocol.
+static const vector<tl_a_op_e>& a_opcodes(tl_protocol_e protocol) {
   static vector<tl_a_op_e> tl_ul = {PutFullData, PutPartialData, Get};
   static vector<tl_a_op_e> tl_uh = {PutFullData, PutPartialData, Get,
                                     ArithmeticData, LogicalData, Intent};
@@ -32,67 +104,79 @@ static tl_a_op_e random_a_opcode(tl_protocol_e protocol) {
                                     AcquireBlock, AcquirePerm};
 
   switch (protocol) {
-    case TL_UL: return tl_ul[random_sample(0, tl_ul.size() - 1)];
-    case TL_UH: return tl_uh[random_sample(0, tl_uh.size() - 1)];
+    case TL_UL: return tl_ul;
+    case TL_UH: return tl_uh;
     
     case TL_C_IO_TERM:
     case TL_C_ROM_TERM:
-    case TL_C:  return tl_c[random_sample(0, tl_c.size() - 1)];
-    default:    assert(false && "Invalid protocol for A channel"); return Get;
+    case TL_C:  return tl_c;
+    default:    assert(false && "Invalid protocol for A channel"); return tl_ul;
   }
 }
 
-static tl_b_op_e random_b_opcode(tl_protocol_e protocol) {
+// Choose an index into `cumulative`, a running total of weights, with
+// probability proportional to each weight. The total must be positive.
+static int random_weighted(TileLinkRandom& rng, const vector<uint64_t>& cumulative) {
+  assert(!cumulative.empty() && cumulative.back() > 0);
+  uint64_t choice = rng.below(cumulative.back());
+
+  int index = 0;
+  while (cumulative[index] <= choice)
+    index++;
+  return index;
+}
+
+static tl_b_op_e random_b_opcode(TileLinkRandom& rng, tl_protocol_e protocol) {
   if (protocol != TL_C) {
     assert(false && "Invalid protocol for B channel");
     return ProbeBlock;
   }
 
-  return (tl_b_op_e)random_sample(6, 7);
+  return (tl_b_op_e)random_sample(rng, 6, 7);
 }
 
-static tl_c_op_e random_c_opcode(tl_protocol_e protocol) {
+static tl_c_op_e random_c_opcode(TileLinkRandom& rng, tl_protocol_e protocol) {
   // Ignore ProbeAck(Data) - they are responses, so should not be randomised.
   static vector<tl_c_op_e> tl_c        = {Release, ReleaseData};
   static vector<tl_c_op_e> tl_rom_term = {Release};
 
   switch (protocol) {
     case TL_C_ROM_TERM: 
-      return tl_rom_term[random_sample(0, tl_rom_term.size() - 1)];
+      return tl_rom_term[random_sample(rng, 0, tl_rom_term.size() - 1)];
     case TL_C:
-      return tl_c[random_sample(0, tl_c.size() - 1)];
+      return tl_c[random_sample(rng, 0, tl_c.size() - 1)];
     default:
       assert(false && "Invalid protocol for C channel");
       return ProbeAck;
   }
 }
 
-static arithmetic_data_param_e random_arithmetic_data_param() {
-  return (arithmetic_data_param_e)random_sample(0, 4);
+static arithmetic_data_param_e random_arithmetic_data_param(TileLinkRandom& rng) {
+  return (arithmetic_data_param_e)random_sample(rng, 0, 4);
 }
 
-static logical_data_param_e random_logical_data_param() {
-  return (logical_data_param_e)random_sample(0, 3);
+static logical_data_param_e random_logical_data_param(TileLinkRandom& rng) {
+  return (logical_data_param_e)random_sample(rng, 0, 3);
 }
 
-static intent_param_e random_intent_param() {
-  return (intent_param_e)random_sample(0, 1);
+static intent_param_e random_intent_param(TileLinkRandom& rng) {
+  return (intent_param_e)random_sample(rng, 0, 1);
 }
 
-static cap_permissions_e random_cap_permission() {
-  return (cap_permissions_e)random_sample(0, 2);
+static cap_permissions_e random_cap_permission(TileLinkRandom& rng) {
+  return (cap_permissions_e)random_sample(rng, 0, 2);
 }
 
-static grow_permissions_e random_grow_permission() {
-  return (grow_permissions_e)random_sample(0, 2);
+static grow_permissions_e random_grow_permission(TileLinkRandom& rng) {
+  return (grow_permissions_e)random_sample(rng, 0, 2);
 }
 
-static prune_permissions_e random_prune_permission() {
-  return (prune_permissions_e)random_sample(0, 2);
+static prune_permissions_e random_prune_permission(TileLinkRandom& rng) {
+  return (prune_permissions_e)random_sample(rng, 0, 2);
 }
 
-static report_permissions_e random_report_permission() {
-  return (report_permissions_e)random_sample(3, 5);
+static report_permissions_e random_report_permission(TileLinkRandom& rng) {
+  return (report_permissions_e)random_sample(rng, 3, 5);
 }
 
 #endif // TL_RANDOM_H
@@ -0,0 +1,301 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdlib>
+#include <iomanip>
+
+#include "logs.h"
+#include "tl_scoreboard.h"
+
+// Bijective 64-bit mix (the splitmix64 finaliser).
+static uint64_t mix(uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+static uint64_t sign_extend(uint64_t value, int bits) {
+  uint64_t sign = 1ULL << (bits - 1);
+  return (value ^ sign) - sign;
+}
+
+
+////////////
+// Memory //
+////////////
+
+uint8_t TileLinkMemory::read_byte(uint64_t address) const {
+  auto word = words.find(address / 8);
+  uint64_t value = (word == words.end()) ? mix(address / 8) : word->second;
+  return value >> ((address % 8) * 8);
+}
+
+void TileLinkMemory::write_byte(uint64_t address, uint8_t value) {
+  auto word = words.find(address / 8);
+  if (word == words.end())
+    word = words.insert({address / 8, mix(address / 8)}).first;
+
+  int shift = (address % 8) * 8;
+  word->second = (word->second & ~(0xFFULL << shift)) |
+                 ((uint64_t)value << shift);
+}
+
+uint64_t TileLinkMemory::read(uint64_t address, int size, int beat,
+                              int width_bytes) const {
+  uint64_t first = beat_address(address, size, beat, width_bytes);
+  uint64_t data = 0;
+
+  for (int i=0; i<beat_bytes(size, width_bytes); i++) {
+    int lane = (first + i) % width_bytes;
+    data |= (uint64_t)read_byte(first + i) << (lane * 8);
+  }
+
+  return data;
+}
+
+void TileLinkMemory::write(uint64_t address, int size, int beat,
+                           int width_bytes, uint64_t data, uint64_t mask) {
+  uint64_t first = beat_address(address, size, beat, width_bytes);
+
+  for (int i=0; i<beat_bytes(size, width_bytes); i++) {
+    int lane = (first + i) % width_bytes;
+    if ((mask >> lane) & 1)
+      write_byte(first + i, data >> (lane * 8));
+  }
+}
+
+uint64_t TileLinkMemory::atomic(const tl_a& request, int beat,
+                                int width_bytes) {
+  uint64_t first = beat_address(request.address, request.size, beat,
+                                width_bytes);
+  int bytes = beat_bytes(request.size, width_bytes);
+  int bits = bytes * 8;
+  int shift = (first % width_bytes) * 8;
+  uint64_t operand_mask = (bits == 64) ? ~0ULL : ((1ULL << bits) - 1);
+
+  uint64_t old_value = read(request.address, request.size, beat, width_bytes);
+  uint64_t a = (old_value >> shift) & operand_mask;
+  uint64_t b = (request.data >> shift) & operand_mask;
+  int64_t a_signed = sign_extend(a, bits);
+  int64_t b_signed = sign_extend(b, bits);
+  uint64_t result;
+
+  if (request.opcode == ArithmeticData) {
+    switch (request.param) {
+      case ArithmeticMin:  result = (a_signed < b_signed) ? a : b; break;
+      case ArithmeticMax:  result = (a_signed > b_signed) ? a : b; break;
+      case ArithmeticMinU: result = (a < b) ? a : b;               break;
+      case ArithmeticMaxU: result = (a > b) ? a : b;               break;
+      case ArithmeticAdd:  result = a + b;                         break;
+      default:             result = a;                             break;
+    }
+  }
+  else {
+    switch (request.param) {
+      case LogicalXor:     result = a ^ b; break;
+      case LogicalOr:      result = a | b; break;
+      case LogicalAnd:     result = a & b; break;
+      case LogicalSwap:    result = b;     break;
+      default:             result = a;     break;
+    }
+  }
+
+  write(request.address, request.size, beat, width_bytes,
+        (result & operand_mask) << shift, request.mask);
+
+  return old_value;
+}
+
+
+////////////////
+// Scoreboard //
+////////////////
+
+TileLinkScoreboard::TileLinkScoreboard() {
+  enabled = false;
+  next_entry = 0;
+  checked = 0;
+  unchecked = 0;
+  untracked = 0;
+}
+
+void TileLinkScoreboard::init(int num_devices) {
+  memories.assign(num_devices, TileLinkMemory());
+}
+
+void TileLinkScoreboard::request_sent(int host, int source, uint64_t address) {
+  requests[((uint64_t)host << 32) | source] = address;
+}
+
+uint64_t TileLinkScoreboard::request_address(int host, int source) const {
+  auto request = requests.find(((uint64_t)host << 32) | source);
+  return (request == requests.end()) ? 0 : request->second;
+}
+
+uint64_t TileLinkScoreboard::digest(uint64_t address, int size,
+                                    int width_bytes, int beat, uint64_t data,
+                                    uint64_t mask) {
+  uint64_t first = beat_address(address, size, beat, width_bytes);
+  uint64_t sum = 0;
+
+  // Bytes without their mask bit set contribute a value no byte can have.
+  for (int i=0; i<beat_bytes(size, width_bytes); i++) {
+    int lane = (first + i) % width_bytes;
+    uint64_t value = ((mask >> lane) & 1) ? ((data >> (lane * 8)) & 0xFF) : 0x100;
+    sum += mix(((first + i) << 9) | value);
+  }
+
+  return sum;
+}
+
+void TileLinkScoreboard::sent(tl_payload_t& stream,
+                              tl_payload_direction_e direction, int host,
+                              uint64_t address, int size, int width_bytes,
+                              int beat, uint64_t data, uint64_t mask,
+                              bool unchecked) {
+  if (beat == 0) {
+    stream.active = enabled;
+
+    if (stream.active) {
+      stream.entry = next_entry++;
+      uint64_t start = beat_address(address, size, 0, width_bytes);
+      entries[stream.entry] = {start + (1 << size), 0, false, false};
+      pending.insert({{start, host, direction}, stream.entry});
+    }
+  }
+
+  if (!stream.active)
+    return;
+
+  entry_t& entry = entries.at(stream.entry);
+  entry.digest += digest(address, size, width_bytes, beat, data, mask);
+  entry.unchecked |= unchecked;
+  entry.complete = (beat + 1) * beat_bytes(size, width_bytes) >= (1 << size);
+}
+
+void TileLinkScoreboard::received(tl_payload_t& stream,
+                                  tl_payload_direction_e direction, int host,
+                                  uint64_t address, int size, int width_bytes,
+                                  int beat, uint64_t data, uint64_t mask,
+                                  bool unchecked) {
+  arrivals.push_back({&stream, direction, host, address, size, width_bytes,
+                      beat, data, mask, unchecked});
+}
+
+void TileLinkScoreboard::end_cycle() {
+  for (auto& arrival : arrivals)
+    check(arrival);
+  arrivals.clear();
+}
+
+void TileLinkScoreboard::check(const arrival_t& arrival) {
+  tl_payload_t& stream = *arrival.stream;
+  int bytes = beat_bytes(arrival.size, arrival.width_bytes);
+  uint64_t first = beat_address(arrival.address, arrival.size, arrival.beat,
+                                arrival.width_bytes);
+
+  if (arrival.beat == 0) {
+    stream.active = enabled;
+    stream.start = first;
+    stream.digest = 0;
+    stream.unchecked = false;
+  }
+
+  if (!stream.active)
+    return;
+
+  stream.cursor = first + bytes;
+  stream.digest += digest(arrival.address, arrival.size, arrival.width_bytes,
+                          arrival.beat, arrival.data, arrival.mask);
+  stream.unchecked |= arrival.unchecked;
+
+  bool last = (arrival.beat + 1) * bytes >= (1 << arrival.size);
+
+  // Look for a sent message ending here whose bytes match. The oldest is
+  // preferred if there are several.
+  const uint64_t NONE = UINT64_MAX;
+  uint64_t match = NONE;
+  uint64_t longer = NONE;
+  bool candidates = false;
+
+  pending_key_t key = {stream.start, arrival.host, arrival.direction};
+  auto range = pending.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    uint64_t id = it->second;
+    const entry_t& entry = entries.at(id);
+    candidates = true;
+
+    if (entry.end == stream.cursor && entry.complete &&
+        (entry.unchecked || stream.unchecked || entry.digest == stream.digest))
+      match = std::min(match, id);
+    else if (entry.end > stream.cursor)
+      longer = std::min(longer, id);
+  }
+
+  if (match != NONE) {
+    if (entries.at(match).unchecked || stream.unchecked)
+      unchecked++;
+    else
+      checked++;
+
+    unlink(match, key);
+    entries.erase(match);
+    stream.start = stream.cursor;
+    stream.digest = 0;
+    stream.unchecked = false;
+  }
+  // The sent message may continue in later beats, or in a later message if
+  // the network split it up.
+  else if (longer != NONE) {
+    if (last) {
+      entry_t& entry = entries.at(longer);
+      entry.digest -= stream.digest;
+      entry.unchecked |= stream.unchecked;
+      advance(longer, key, stream.cursor);
+      stream.start = stream.cursor;
+      stream.digest = 0;
+    }
+  }
+  else if (candidates) {
+    MUNTJAC_ERROR << "Scoreboard: payload "
+                  << (arrival.direction == TO_HOST ? "to host" : "to device")
+                  << " at 0x" << std::hex << stream.start << "-0x"
+                  << stream.cursor << " doesn't match what was sent (digest 0x"
+                  << stream.digest << ")" << std::dec << endl;
+    for (auto it = range.first; it != range.second; ++it) {
+      const entry_t& entry = entries.at(it->second);
+      MUNTJAC_ERROR << "  sent: 0x" << std::hex << stream.start << "-0x"
+                    << entry.end << " digest 0x" << entry.digest << std::dec
+                    << (entry.complete ? "" : " (incomplete)") << endl;
+    }
+    abort();
+  }
+  else if (last) {
+    untracked++;
+    stream.start = stream.cursor;
+    stream.digest = 0;
+  }
+}
+
+void TileLinkScoreboard::advance(uint64_t id, const pending_key_t& from,
+                                 uint64_t to) {
+  unlink(id, from);
+  pending.insert({{to, from.host, from.direction}, id});
+}
+
+void TileLinkScoreboard::unlink(uint64_t id, const pending_key_t& key) {
+  auto range = pending.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == id) {
+      pending.erase(it);
+      return;
+    }
+  }
+}
+
+void TileLinkScoreboard::print_summary(std::ostream& os) const {
+  os << "Scoreboard: " << checked << " payloads checked, " << unchecked
+     << " unchecked (denied), " << untracked << " not sent by the harness, "
+     << entries.size() << " still in flight" << endl;
+}
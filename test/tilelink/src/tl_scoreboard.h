@@ -0,0 +1,206 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TL_SCOREBOARD_H
+#define TL_SCOREBOARD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "tilelink.h"
+
+using std::unordered_map;
+using std::unordered_multimap;
+using std::vector;
+
+// Address of the first byte carried by beat `beat` of a message, and the
+// number of bytes it carries. Byte lane `i` of a beat holds the byte at the
+// address which is `i` modulo the channel width.
+inline uint64_t beat_address(uint64_t address, int size, int beat,
+                             int width_bytes) {
+  uint64_t size_bytes = 1 << size;
+  if (size_bytes >= (uint64_t)width_bytes)
+    return (address & ~(size_bytes - 1)) + beat * width_bytes;
+  else
+    return address;
+}
+inline int beat_bytes(int size, int width_bytes) {
+  return std::min(1 << size, width_bytes);
+}
+
+// Sparse contents of one device's address space. Locations which have never
+// been written hold a fixed pattern derived from their address, so reads are
+// reproducible without storing anything.
+class TileLinkMemory {
+public:
+  // Contents of the bytes carried by a beat. Unused byte lanes are zero.
+  uint64_t read(uint64_t address, int size, int beat, int width_bytes) const;
+
+  // Update the bytes carried by a beat, where enabled by `mask`.
+  void write(uint64_t address, int size, int beat, int width_bytes,
+             uint64_t data, uint64_t mask);
+
+  // Apply one beat of an ArithmeticData/LogicalData request, and return the
+  // previous contents. Each beat holds a single operand.
+  uint64_t atomic(const tl_a& request, int beat, int width_bytes);
+
+private:
+  uint8_t read_byte(uint64_t address) const;
+  void write_byte(uint64_t address, uint8_t value);
+
+  // Aligned 8-byte words which have been written.
+  unordered_map<uint64_t, uint64_t> words;
+};
+
+// Which way a payload travels through the network.
+typedef enum {
+  TO_DEVICE = 0,  // A and C channels
+  TO_HOST   = 1   // D channel
+} tl_payload_direction_e;
+
+// Progress through the payload currently crossing one channel end. Messages
+// don't interleave on a channel, so one is enough.
+typedef struct {
+  // Is the current message being tracked? Decided at its first beat.
+  bool     active;
+
+  // Senders: the summary being accumulated for the current message.
+  uint64_t entry;
+
+  // Receivers: bytes [start, cursor) have arrived but not yet been matched
+  // with a sent message. `digest` summarises them.
+  uint64_t start;
+  uint64_t cursor;
+  uint64_t digest;
+  bool     unchecked;
+} tl_payload_t;
+
+// Check that every payload byte arrives with the value and mask it was sent
+// with, however the network splits, merges or resizes the messages.
+//
+// Devices are backed by reference memories, so Get, atomic and Put responses
+// have predictable contents. Each payload is summarised as it enters the
+// network by summing a hash of (address, value) over its bytes. The sum
+// doesn't depend on how the bytes are divided into beats or messages, so
+// receivers accumulate the same sum as beats arrive and compare it whenever
+// they reach the end of a sent message. Each in-flight message costs one
+// summary, regardless of its length.
+class TileLinkScoreboard {
+public:
+  TileLinkScoreboard();
+
+  // Create an empty reference memory for each device.
+  void init(int num_devices);
+
+  TileLinkMemory& memory(int device) {return memories[device];}
+
+  // Only check messages which start after this point. Directed tests
+  // deliberately send malformed messages.
+  void enable()  {enabled = true;}
+  void disable() {enabled = false;}
+
+  // Hosts need the request's address to locate the bytes in a response.
+  void request_sent(int host, int source, uint64_t address);
+  uint64_t request_address(int host, int source) const;
+
+  // Beat `beat` of a message at `address` entered the network. `host` is the
+  // host which sent or will receive the payload. Bytes without `mask` set
+  // carry no data. `unchecked` payloads (e.g. denied responses) only need to
+  // arrive, not to match.
+  void sent(tl_payload_t& stream, tl_payload_direction_e direction, int host,
+            uint64_t address, int size, int width_bytes, int beat,
+            uint64_t data, uint64_t mask, bool unchecked);
+
+  // Beat `beat` of a message at `address` left the network. Checked in
+  // end_cycle(), once every beat sent this cycle has been recorded.
+  void received(tl_payload_t& stream, tl_payload_direction_e direction,
+                int host, uint64_t address, int size, int width_bytes,
+                int beat, uint64_t data, uint64_t mask, bool unchecked);
+
+  // Check all beats received this cycle. Aborts on the first mismatch.
+  void end_cycle();
+
+  void print_summary(std::ostream& os) const;
+
+private:
+
+  // One sent message, or the part of it which hasn't arrived yet.
+  typedef struct {
+    uint64_t end;        // Address after the final byte
+    uint64_t digest;     // Sent bytes which haven't arrived
+    bool     complete;   // All beats have been sent
+    bool     unchecked;
+  } entry_t;
+
+  typedef struct {
+    tl_payload_t* stream;
+    tl_payload_direction_e direction;
+    int host;
+    uint64_t address;
+    int size;
+    int width_bytes;
+    int beat;
+    uint64_t data;
+    uint64_t mask;
+    bool unchecked;
+  } arrival_t;
+
+  // Where the next bytes of a sent message are expected. Pieces of messages
+  // from different hosts can be interleaved by the network, even when they
+  // have the same address, so they are kept apart. Source IDs may be
+  // remapped inside the network, but the host is known at both ends.
+  typedef struct pending_key {
+    uint64_t address;
+    int host;
+    tl_payload_direction_e direction;
+
+    bool operator==(const pending_key& other) const {
+      return address == other.address && host == other.host &&
+             direction == other.direction;
+    }
+  } pending_key_t;
+
+  struct pending_key_hash {
+    size_t operator()(const pending_key_t& key) const {
+      return std::hash<uint64_t>()((key.address << 1 | key.direction) ^
+                                   ((uint64_t)key.host << 56));
+    }
+  };
+
+  static uint64_t digest(uint64_t address, int size, int width_bytes,
+                         int beat, uint64_t data, uint64_t mask);
+
+  void check(const arrival_t& arrival);
+
+  // Move an entry so it is found at `to`.
+  void advance(uint64_t id, const pending_key_t& from, uint64_t to);
+
+  void unlink(uint64_t id, const pending_key_t& key);
+
+  bool enabled;
+
+  vector<TileLinkMemory> memories;
+
+  // Address of each outstanding request, keyed by host and source ID.
+  unordered_map<uint64_t, uint64_t> requests;
+
+  // Sent messages which haven't fully arrived, indexed by the address of the
+  // next byte expected and the host involved.
+  unordered_map<uint64_t, entry_t> entries;
+  unordered_multimap<pending_key_t, uint64_t, pending_key_hash> pending;
+  uint64_t next_entry;
+
+  vector<arrival_t> arrivals;
+
+  // Messages compared successfully, arrived without being compared, and
+  // arrived without having been sent (e.g. responses from the network itself).
+  uint64_t checked;
+  uint64_t unchecked;
+  uint64_t untracked;
+};
+
+#endif // TL_SCOREBOARD_H
@@ -0,0 +1,253 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cstring>
+
+#include "logs.h"
+#include "tl_stimulus.h"
+
+extern bool has_payload(tl_a_op_e opcode);
+extern bool has_payload(tl_c_op_e opcode);
+extern bool has_payload(tl_d_op_e opcode);
+
+static const char MAGIC[8] = {'T', 'L', 'S', 'T', 'I', 'M', '1', '\n'};
+
+static int payload_beats(int size, int width_bytes) {
+  return std::max(1, (1 << size) / width_bytes);
+}
+
+int message_beats(const tl_a& beat, int width_bytes) {
+  return has_payload(beat.opcode) ? payload_beats(beat.size, width_bytes) : 1;
+}
+
+int message_beats(const tl_b& /*beat*/, int /*width_bytes*/) {
+  // We only support B messages without payloads.
+  return 1;
+}
+
+int message_beats(const tl_c& beat, int width_bytes) {
+  return has_payload(beat.opcode) ? payload_beats(beat.size, width_bytes) : 1;
+}
+
+int message_beats(const tl_d& beat, int width_bytes) {
+  return has_payload(beat.opcode) ? payload_beats(beat.size, width_bytes) : 1;
+}
+
+int message_beats(const tl_e& /*beat*/, int /*width_bytes*/) {
+  return 1;
+}
+
+TileLinkStimulus::TileLinkStimulus() {
+  fast_replay = false;
+  cycle = 0;
+  last_record = 0;
+  beats_to_replay = 0;
+}
+
+TileLinkStimulus::~TileLinkStimulus() {
+  close();
+}
+
+void TileLinkStimulus::record(string filename, int num_hosts,
+                              int num_devices) {
+  this->filename = filename;
+  out.open(filename, std::ios::binary);
+
+  if (!out.good()) {
+    MUNTJAC_ERROR << "Unable to write stimulus to " << filename << endl;
+    exit(1);
+  }
+
+  out.write(MAGIC, sizeof(MAGIC));
+  write_varint(num_hosts);
+  write_varint(num_devices);
+}
+
+void TileLinkStimulus::replay(string filename, int num_hosts,
+                              int num_devices, bool fast) {
+  this->filename = filename;
+  fast_replay = fast;
+  in.open(filename, std::ios::binary);
+
+  char magic[sizeof(MAGIC)];
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    MUNTJAC_ERROR << "Unable to read stimulus from " << filename << endl;
+    exit(1);
+  }
+
+  uint64_t hosts = read_varint();
+  uint64_t devices = read_varint();
+  if (hosts != (uint64_t)num_hosts || devices != (uint64_t)num_devices) {
+    MUNTJAC_ERROR << filename << " was recorded with " << hosts << " hosts and "
+                  << devices << " devices, but the configuration has "
+                  << num_hosts << " and " << num_devices << endl;
+    exit(1);
+  }
+}
+
+void TileLinkStimulus::close() {
+  if (out.is_open()) {
+    out.close();
+    MUNTJAC_LOG(1) << "Wrote stimulus to " << filename << endl;
+  }
+  if (in.is_open())
+    in.close();
+}
+
+void TileLinkStimulus::record_ready(int endpoint, int channel, bool ready) {
+  write_header(READY, endpoint, channel);
+  write_varint(ready);
+}
+
+bool TileLinkStimulus::next(bool& is_beat, int& endpoint, int& channel,
+                            uint64_t& cycle_stamp, bool& ready) {
+  // Check for the end of the trace before reading a full record.
+  if (in.peek() == EOF)
+    return false;
+
+  last_record += read_varint();
+  uint64_t header = read_varint();
+
+  is_beat = (header & 1) == BEAT;
+  channel = (header >> 1) & 0x7;
+  endpoint = header >> 4;
+
+  if (is_beat)
+    cycle_stamp = last_record - read_varint();
+  else {
+    cycle_stamp = last_record;
+    ready = read_varint();
+  }
+
+  return true;
+}
+
+void TileLinkStimulus::write_header(record_e type, int endpoint, int channel) {
+  write_varint(cycle - last_record);
+  write_varint(((uint64_t)endpoint << 4) | (channel << 1) | type);
+  last_record = cycle;
+}
+
+void TileLinkStimulus::write_varint(uint64_t value) {
+  char bytes[10];
+  int length = 0;
+
+  do {
+    bytes[length] = value & 0x7F;
+    value >>= 7;
+    if (value != 0)
+      bytes[length] |= 0x80;
+    length++;
+  } while (value != 0);
+
+  out.write(bytes, length);
+}
+
+uint64_t TileLinkStimulus::read_varint() {
+  uint64_t value = 0;
+
+  for (int shift=0; shift<64; shift+=7) {
+    int byte = in.get();
+    if (byte == EOF) {
+      MUNTJAC_ERROR << filename << " ends part way through a record" << endl;
+      exit(1);
+    }
+
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      break;
+  }
+
+  return value;
+}
+
+void TileLinkStimulus::write(const tl_a& beat) {
+  write_varint(beat.opcode);
+  write_varint(beat.param);
+  write_varint(beat.size);
+  write_varint(beat.source);
+  write_varint(beat.address);
+  write_varint(beat.mask);
+  write_varint(beat.corrupt);
+  write_varint(beat.data);
+}
+
+void TileLinkStimulus::write(const tl_b& beat) {
+  write_varint(beat.opcode);
+  write_varint(beat.param);
+  write_varint(beat.size);
+  write_varint(beat.source);
+  write_varint(beat.address);
+}
+
+void TileLinkStimulus::write(const tl_c& beat) {
+  write_varint(beat.opcode);
+  write_varint(beat.param);
+  write_varint(beat.size);
+  write_varint(beat.source);
+  write_varint(beat.address);
+  write_varint(beat.corrupt);
+  write_varint(beat.data);
+}
+
+void TileLinkStimulus::write(const tl_d& beat) {
+  write_varint(beat.opcode);
+  write_varint(beat.param);
+  write_varint(beat.size);
+  write_varint(beat.source);
+  write_varint(beat.sink);
+  write_varint(beat.denied);
+  write_varint(beat.corrupt);
+  write_varint(beat.data);
+}
+
+void TileLinkStimulus::write(const tl_e& beat) {
+  write_varint(beat.sink);
+}
+
+void TileLinkStimulus::read(tl_a& beat) {
+  beat.opcode = (tl_a_op_e)read_varint();
+  beat.param = read_varint();
+  beat.size = read_varint();
+  beat.source = read_varint();
+  beat.address = read_varint();
+  beat.mask = read_varint();
+  beat.corrupt = read_varint();
+  beat.data = read_varint();
+}
+
+void TileLinkStimulus::read(tl_b& beat) {
+  beat.opcode = (tl_b_op_e)read_varint();
+  beat.param = read_varint();
+  beat.size = read_varint();
+  beat.source = read_varint();
+  beat.address = read_varint();
+}
+
+void TileLinkStimulus::read(tl_c& beat) {
+  beat.opcode = (tl_c_op_e)read_varint();
+  beat.param = read_varint();
+  beat.size = read_varint();
+  beat.source = read_varint();
+  beat.address = read_varint();
+  beat.corrupt = read_varint();
+  beat.data = read_varint();
+}
+
+void TileLinkStimulus::read(tl_d& beat) {
+  beat.opcode = (tl_d_op_e)read_varint();
+  beat.param = read_varint();
+  beat.size = read_varint();
+  beat.source = read_varint();
+  beat.sink = read_varint();
+  beat.denied = read_varint();
+  beat.corrupt = read_varint();
+  beat.data = read_varint();
+}
+
+void TileLinkStimulus::read(tl_e& beat) {
+  beat.sink = read_varint();
+}
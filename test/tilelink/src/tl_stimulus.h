@@ -0,0 +1,155 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TL_STIMULUS_H
+#define TL_STIMULUS_H
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "tilelink.h"
+
+using std::deque;
+using std::multiset;
+using std::pair;
+using std::set;
+using std::string;
+
+// Number of beats in the message starting with `beat`.
+int message_beats(const tl_a& beat, int width_bytes);
+int message_beats(const tl_b& beat, int width_bytes);
+int message_beats(const tl_c& beat, int width_bytes);
+int message_beats(const tl_d& beat, int width_bytes);
+int message_beats(const tl_e& beat, int width_bytes);
+
+// Stimulus to replay on one channel end: beats to send, with the cycle each
+// was first offered, or changes to a receiver's flow control.
+template<class channel>
+struct tl_replay_t {
+  deque<pair<uint64_t, channel>> beats;
+  deque<pair<uint64_t, bool>> ready;
+
+  // Beats of the current message sent so far.
+  int beats_sent = 0;
+};
+
+// Dependencies between the messages an endpoint sends and receives during
+// replay. If the network's timing changes, messages may arrive in a different
+// order, so responses wait for their particular request rather than for a
+// point in time.
+typedef struct {
+  // Messages received which enable a response, e.g. an A request with a
+  // given source ID enables the D response with that ID.
+  multiset<uint64_t> received;
+
+  // IDs of sent messages which are still awaiting a response, and so can't be
+  // reused.
+  set<uint64_t> in_flight;
+} tl_replay_state_t;
+
+// Key for `tl_replay_state_t`, unique to a channel and ID/address.
+inline uint64_t replay_key(int channel, uint64_t id) {
+  return ((uint64_t)channel << 60) ^ id;
+}
+
+// Compact binary record of the stimulus which the harness applies to the
+// network: every beat accepted from a host or device, and every change to a
+// receiver's `ready` signal, with cycle stamps. Replaying it drives the same
+// stimulus without consulting the random models.
+//
+// Numbers are stored as LEB128 varints and cycles as deltas, so most records
+// take a few bytes plus any data.
+class TileLinkStimulus {
+public:
+  TileLinkStimulus();
+  ~TileLinkStimulus();
+
+  // Start writing a new trace.
+  void record(string filename, int num_hosts, int num_devices);
+
+  // Start reading a trace. The configuration must match the one recorded.
+  // `fast` replay ignores cycle stamps, so beats are sent as soon as the
+  // network and their dependencies allow, and receivers are always ready.
+  void replay(string filename, int num_hosts, int num_devices, bool fast);
+
+  void close();
+
+  bool recording() const {return out.is_open();}
+  bool replaying() const {return in.is_open();}
+  bool fast() const      {return fast_replay;}
+
+  // Cycles since the simulation started.
+  uint64_t now() const {return cycle;}
+  void tick()          {cycle++;}
+
+  // Record a beat which was offered at cycle `offered` and accepted now.
+  // `endpoint` identifies the host/device; `channel` is from channel_index().
+  template<class channel_t>
+  void record_beat(int endpoint, int channel, const channel_t& beat,
+                   uint64_t offered) {
+    write_header(BEAT, endpoint, channel);
+    write_varint(cycle - offered);
+    write(beat);
+  }
+
+  // Record a receiver changing its `ready` signal now.
+  void record_ready(int endpoint, int channel, bool ready);
+
+  // Read the next record's header. Returns false at the end of the trace.
+  // Beats must then be read with read_beat().
+  bool next(bool& is_beat, int& endpoint, int& channel, uint64_t& cycle_stamp,
+            bool& ready);
+
+  template<class channel_t>
+  void read_beat(channel_t& beat) {
+    read(beat);
+    beats_to_replay++;
+  }
+
+  // Beats read but not yet sent.
+  uint64_t beats_remaining() const {return beats_to_replay;}
+  void beat_replayed() {beats_to_replay--;}
+
+private:
+
+  typedef enum {
+    BEAT  = 0,
+    READY = 1
+  } record_e;
+
+  void write_header(record_e type, int endpoint, int channel);
+
+  void write_varint(uint64_t value);
+  uint64_t read_varint();
+
+  void write(const tl_a& beat);
+  void write(const tl_b& beat);
+  void write(const tl_c& beat);
+  void write(const tl_d& beat);
+  void write(const tl_e& beat);
+
+  void read(tl_a& beat);
+  void read(tl_b& beat);
+  void read(tl_c& beat);
+  void read(tl_d& beat);
+  void read(tl_e& beat);
+
+  std::ofstream out;
+  std::ifstream in;
+  string filename;
+  bool fast_replay;
+
+  uint64_t cycle;
+
+  // Cycle of the previous record written/read.
+  uint64_t last_record;
+
+  uint64_t beats_to_replay;
+};
+
+#endif // TL_STIMULUS_H
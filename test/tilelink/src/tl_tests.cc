@@ -15,7 +15,7 @@ void valid_write_operation(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  tl_message<tl_a> message(host.a, false, {{"opcode", (int)PutFullData}});
+  tl_message<tl_a> message(host.a, false, {{TL_OPCODE, (int)PutFullData}});
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
@@ -38,11 +38,11 @@ void valid_read_operation(TileLinkSimulation& sim) {
   auto& host = sim.host(1);
   auto& device = sim.device(0);
 
-  tl_message<tl_a> message(host.a, false, {{"opcode", (int)Get}});
+  tl_message<tl_a> message(host.a, false, {{TL_OPCODE, (int)Get}});
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
-  device.d.change_next_beat({{"data", 0x1234}});
+  device.d.change_next_beat({{TL_DATA, 0x1234}});
 
   tl_a req_received = device.a.await();
   assert(req_received.address == request.address);
@@ -63,7 +63,7 @@ void valid_dev1_operation(TileLinkSimulation& sim) {
   auto& device = sim.device(1);
   
   tl_message<tl_a> message(host.a, false, 
-                           {{"address", host.a.get_address(0x3000, 1)}});
+                           {{TL_ADDRESS, host.a.get_address(0x3000, 1)}});
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
@@ -96,7 +96,7 @@ void multiple_valid_requests(TileLinkSimulation& sim) {
   
   // host1 -> dev1 request
   tl_message<tl_a> dev1_message(host1.a, false, 
-                                {{"address", host1.a.get_address(0x3000, 1)}});
+                                {{TL_ADDRESS, host1.a.get_address(0x3000, 1)}});
   tl_a dev1_request = dev1_message.next_beat(false);
   host1.a.start_transaction(dev1_request.source);
   host1.a.send(dev1_request);
@@ -125,8 +125,8 @@ void multibeat_tlc(TileLinkSimulation& sim) {
   auto& device = sim.device(0);
 
   tl_message<tl_a> message(host.a, false, 
-                           {{"opcode", (int)PutFullData},
-                            {"size", 4}}); // 2^4 = 16 bytes = 2 beats
+                           {{TL_OPCODE, (int)PutFullData},
+                            {TL_SIZE, 4}}); // 2^4 = 16 bytes = 2 beats
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
@@ -157,9 +157,9 @@ void multibeat_tlul(TileLinkSimulation& sim) {
   auto& device = sim.device(2); // TL-UL
   
   tl_message<tl_a> message(host.a, false, 
-                           {{"opcode", (int)PutFullData}, 
-                            {"size", 4}, // 2^4 = 16 bytes = 2 beats
-                            {"address", host.a.get_address(0x3000, 2)}});
+                           {{TL_OPCODE, (int)PutFullData}, 
+                            {TL_SIZE, 4}, // 2^4 = 16 bytes = 2 beats
+                            {TL_ADDRESS, host.a.get_address(0x3000, 2)}});
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
@@ -184,14 +184,34 @@ void multibeat_tlul(TileLinkSimulation& sim) {
   tl_d resp2_received = host.d.await();
 }
 
+// Multibeat writes from two hosts to the same address, each split into
+// single-beat messages in front of a TL-UL device. The scoreboard must keep
+// the pieces of the two messages apart (should pass).
+void concurrent_split_writes(TileLinkSimulation& sim) {
+  auto& host0 = sim.host(0);
+  auto& host1 = sim.host(1);
+
+  sim.scoreboard.enable();
+
+  for (auto host : {&host0, &host1}) {
+    host->a.queue_request(false,
+                          {{TL_OPCODE, (int)PutFullData},
+                           {TL_SIZE, 5}, // 2^5 = 32 bytes = 4 beats
+                           {TL_ADDRESS, host->a.get_address(0x3000, 2)}});
+  }
+
+  sim.run(false);
+  sim.scoreboard.disable();
+}
+
 // Only requests with data payloads are allowed to be marked corrupt.
 void a_corrupt_payload(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
   tl_message<tl_a> message(host.a, false, 
-                           {{"opcode", (int)PutFullData},
-                            {"corrupt", true}});
+                           {{TL_OPCODE, (int)PutFullData},
+                            {TL_CORRUPT, true}});
   tl_a request = message.next_beat(false);
   host.a.start_transaction(request.source);
   host.a.send(request);
@@ -207,6 +227,7 @@ void all_passing_tests(TileLinkSimulation& sim) {
   multiple_valid_requests(sim);
   multibeat_tlc(sim);
   multibeat_tlul(sim);
+  concurrent_split_writes(sim);
   a_corrupt_payload(sim);
 }
 
@@ -215,8 +236,8 @@ void a_illegal_opcode(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
   // Send TL-UH request to TL-UL device.
-  host.a.queue_request(false, {{"opcode", (int)ArithmeticData},
-                               {"address", host.a.get_address(0x3000, 2)}});
+  host.a.queue_request(false, {{TL_OPCODE, (int)ArithmeticData},
+                               {TL_ADDRESS, host.a.get_address(0x3000, 2)}});
   
   sim.run(false);
 }
@@ -225,8 +246,8 @@ void a_illegal_opcode(TileLinkSimulation& sim) {
 void a_illegal_param(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"param",                 2}}); // Only 0 allowed
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_PARAM,                 2}}); // Only 0 allowed
   
   sim.run(false);
 }
@@ -235,9 +256,9 @@ void a_illegal_param(TileLinkSimulation& sim) {
 void a_size_too_small(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get},
-                               {"size",          1},   // 2**1 = 2 byte request
-                               {"mask",        0xF}}); // 4 bits implies 4 bytes
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get},
+                               {TL_SIZE,          1},   // 2**1 = 2 byte request
+                               {TL_MASK,        0xF}}); // 4 bits implies 4 bytes
   
   sim.run(false);
 }
@@ -246,9 +267,9 @@ void a_size_too_small(TileLinkSimulation& sim) {
 void a_size_mask_mismatch(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"size",          3},   // 2**3 = 8 byte request
-                               {"mask",        0xF}}); // 4 bits implies 4 bytes
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_SIZE,          3},   // 2**3 = 8 byte request
+                               {TL_MASK,        0xF}}); // 4 bits implies 4 bytes
   
   sim.run(false);
 }
@@ -257,8 +278,8 @@ void a_size_mask_mismatch(TileLinkSimulation& sim) {
 void a_unaligned_address(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"size",         3},   // 2**3 = 8 byte request
-                               {"address", 0x3001}});
+  host.a.queue_request(false, {{TL_SIZE,         3},   // 2**3 = 8 byte request
+                               {TL_ADDRESS, 0x3001}});
   
   sim.run(false);
 }
@@ -268,11 +289,11 @@ void a_multibeat_addr_inc(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"size",                  4}, // 2 beats
-                               {"address",          0x3000}});
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_SIZE,                  4}, // 2 beats
+                               {TL_ADDRESS,          0x3000}});
   host.a.change_next_beat({}); // Let first beat through as-is
-  host.a.change_next_beat({{"address", 0x3000}}); // Increment of 0
+  host.a.change_next_beat({{TL_ADDRESS, 0x3000}}); // Increment of 0
   
   sim.run(false);
 }
@@ -282,10 +303,10 @@ void a_multibeat_addr_inc(TileLinkSimulation& sim) {
 void a_multibeat_ctrl_const(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"size",          4}}); // 2**4 = 16 bytes = 2 beats
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_SIZE,          4}}); // 2**4 = 16 bytes = 2 beats
   host.a.change_next_beat({}); // Let first beat through as-is
-  host.a.change_next_beat({{"size", 3}}); // Not allowed
+  host.a.change_next_beat({{TL_SIZE, 3}}); // Not allowed
   
   sim.run(false);
 }
@@ -297,8 +318,8 @@ void a_too_many_beats(TileLinkSimulation& sim) {
 
   // Need to use lower-level methods to force a late response.
   tl_message<tl_a> message(host.a, false, 
-                           {{"opcode", (int)PutFullData},
-                            {"size", 4}}); // 2^4 = 16 bytes = 2 beats
+                           {{TL_OPCODE, (int)PutFullData},
+                            {TL_SIZE, 4}}); // 2^4 = 16 bytes = 2 beats
   tl_a request = message.next_beat(false);
   host.a.send(request);
 
@@ -342,8 +363,8 @@ void a_too_few_beats(TileLinkSimulation& sim) {
   
   // Need to use lower-level methods to force an early response.
   tl_message<tl_a> message(host.a, false, 
-                           {{"opcode", (int)PutFullData},
-                            {"size", 4}}); // 2^4 = 16 bytes = 2 beats
+                           {{TL_OPCODE, (int)PutFullData},
+                            {TL_SIZE, 4}}); // 2^4 = 16 bytes = 2 beats
   tl_a request = message.next_beat(false);
   host.a.send(request);
 
@@ -360,9 +381,9 @@ void a_too_few_beats(TileLinkSimulation& sim) {
 void a_noncontiguous_mask(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get}, 
-                               {"size",          2},
-                               {"mask",       0x33}}); // In binary: 00110011
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get}, 
+                               {TL_SIZE,          2},
+                               {TL_MASK,       0x33}}); // In binary: 00110011
 
   sim.run(false);
 }
@@ -371,10 +392,10 @@ void a_noncontiguous_mask(TileLinkSimulation& sim) {
 void a_multibeat_bad_mask(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"size",          4}}); // 2**4 = 16 bytes = 2 beats
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_SIZE,          4}}); // 2**4 = 16 bytes = 2 beats
   host.a.change_next_beat({}); // Let first beat through as-is
-  host.a.change_next_beat({{"mask", 0xF0}}); // Not allowed
+  host.a.change_next_beat({{TL_MASK, 0xF0}}); // Not allowed
   
   sim.run(false);
 }
@@ -385,10 +406,10 @@ void a_multibeat_bad_mask(TileLinkSimulation& sim) {
 void a_misaligned_mask(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData},
-                               {"size",          0},   // 2**0 = 1 byte request
-                               {"address",  0x3001},   // Offset = 1
-                               {"mask",        0x4}}); // Offset = 2 (mismatch)
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData},
+                               {TL_SIZE,          0},   // 2**0 = 1 byte request
+                               {TL_ADDRESS,  0x3001},   // Offset = 1
+                               {TL_MASK,        0x4}}); // Offset = 2 (mismatch)
   
   sim.run(false);
 }
@@ -398,8 +419,8 @@ void a_corrupt_without_payload(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get},
-                               {"corrupt",       1}});
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get},
+                               {TL_CORRUPT,       1}});
   
   sim.run(false);
 }
@@ -409,8 +430,8 @@ void d_illegal_opcode(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData}});
-  device.d.change_next_beat({{"opcode", (int)HintAck}}); // Should be AccessAck
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData}});
+  device.d.change_next_beat({{TL_OPCODE, (int)HintAck}}); // Should be AccessAck
   
   sim.run(false);
 }
@@ -420,8 +441,8 @@ void d_illegal_param(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)PutFullData}});
-  device.d.change_next_beat({{"param", 2}}); // Should be 0
+  host.a.queue_request(false, {{TL_OPCODE, (int)PutFullData}});
+  device.d.change_next_beat({{TL_PARAM, 2}}); // Should be 0
   
   sim.run(false);
 }
@@ -431,8 +452,8 @@ void d_size_mismatch(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"size", 3}});
-  device.d.change_next_beat({{"size", 2}});
+  host.a.queue_request(false, {{TL_SIZE, 3}});
+  device.d.change_next_beat({{TL_SIZE, 2}});
   
   sim.run(false);
 }
@@ -445,12 +466,12 @@ void d_too_many_beats(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get},
-                               {"size",          4}, // 2**4 = 16 bytes = 2 beats
-                               {"address",  0x3000}});
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get},
+                               {TL_SIZE,          4}, // 2**4 = 16 bytes = 2 beats
+                               {TL_ADDRESS,  0x3000}});
   device.d.change_next_beat({}); // Let first beat through as-is
-  device.d.change_next_beat({{"duplicate_beat", 0}}); // Duplicate second beat
-  device.d.change_next_beat({{"address", 0x3010}}); // Valid third beat address
+  device.d.change_next_beat({{TL_DUPLICATE_BEAT, 0}}); // Duplicate second beat
+  device.d.change_next_beat({{TL_ADDRESS, 0x3010}}); // Valid third beat address
   
   sim.run(false);
 }
@@ -461,10 +482,10 @@ void d_too_few_beats(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get},
-                               {"size",          4}}); // 2**4 = 16 bytes = 2 beats
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get},
+                               {TL_SIZE,          4}}); // 2**4 = 16 bytes = 2 beats
   device.d.change_next_beat({}); // Let first beat through as-is
-  device.d.change_next_beat({{"drop_beat", 0}}); // Drop the second beat
+  device.d.change_next_beat({{TL_DROP_BEAT, 0}}); // Drop the second beat
   
   sim.run(false);
 }
@@ -475,7 +496,7 @@ void d_response_without_request(TileLinkSimulation& sim) {
   auto& device = sim.device(0);
 
   host.a.queue_request(false);
-  device.d.change_next_beat({{"source", 1}}); // Should be match host 0
+  device.d.change_next_beat({{TL_SOURCE, 1}}); // Should be match host 0
   
   sim.run(false);
 }
@@ -485,9 +506,9 @@ void d_denied_without_corrupt(TileLinkSimulation& sim) {
   auto& host = sim.host(0);
   auto& device = sim.device(0);
 
-  host.a.queue_request(false, {{"opcode", (int)Get}});
-  device.d.change_next_beat({{"denied",  1},
-                             {"corrupt", 0}});
+  host.a.queue_request(false, {{TL_OPCODE, (int)Get}});
+  device.d.change_next_beat({{TL_DENIED,  1},
+                             {TL_CORRUPT, 0}});
   
   sim.run(false);
 }
@@ -520,5 +541,6 @@ vector<tl_test> tests = {
   {d_too_many_beats, "Multibeat response with too many beats"},
   {d_too_few_beats, "Multibeat response with too few beats"},
   {d_response_without_request, "Response received with no matching request"},
-  {d_denied_without_corrupt, "Response denied but not marked corrupt"}
+  {d_denied_without_corrupt, "Response denied but not marked corrupt"},
+  {concurrent_split_writes, "Split multibeat writes from two hosts to one address (should pass)"}
 };
@@ -0,0 +1,97 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+
+#include "logs.h"
+#include "tl_traffic.h"
+
+// Round `address` down so it is a multiple of `unit`.
+extern uint64_t align(uint64_t address, uint64_t unit);
+
+TileLinkTraffic::TileLinkTraffic(const tl_traffic_config_t& config,
+                                 int max_size) :
+    config(config) {
+  uint64_t total = 0;
+  for (int size=0; size<=max_size; size++) {
+    total += size_weight(size);
+    size_cumulative.push_back(total);
+  }
+
+  if (total == 0) {
+    MUNTJAC_ERROR << "SizeWeights must allow at least one size up to MaxSize" << endl;
+    exit(1);
+  }
+
+  // Cumulative weights are indexed in the same order as a_opcodes().
+  for (int protocol=TL_UL; protocol<=TL_C; protocol++) {
+    total = 0;
+    for (tl_a_op_e opcode : a_opcodes((tl_protocol_e)protocol)) {
+      total += opcode_weight(opcode);
+      opcode_cumulative[protocol].push_back(total);
+    }
+  }
+
+  if (config.address_pattern == ADDRESS_STRIDED &&
+      (config.address_stride <= 0 || config.address_stride % ADDRESS_RANGE == 0)) {
+    MUNTJAC_ERROR << "AddressStride must be positive and move within the "
+                  << ADDRESS_RANGE << "-byte address range" << endl;
+    exit(1);
+  }
+
+  next_address = 0;
+}
+
+uint64_t TileLinkTraffic::opcode_weight(tl_a_op_e opcode) const {
+  if (config.opcode_weights.empty())
+    return 1;
+  else if ((size_t)opcode < config.opcode_weights.size())
+    return config.opcode_weights[opcode];
+  else
+    return 0;
+}
+
+uint64_t TileLinkTraffic::size_weight(int size) const {
+  if (config.size_weights.empty())
+    return 1;
+  else if ((size_t)size < config.size_weights.size())
+    return config.size_weights[size];
+  else
+    return 0;
+}
+
+tl_a_op_e TileLinkTraffic::a_opcode(TileLinkRandom& rng,
+                                    tl_protocol_e protocol) const {
+  if (opcode_cumulative[protocol].back() == 0) {
+    MUNTJAC_ERROR << "OpcodeWeights doesn't allow any opcodes supported by "
+                  << "protocol " << protocol << endl;
+    exit(1);
+  }
+
+  return a_opcodes(protocol)[random_weighted(rng, opcode_cumulative[protocol])];
+}
+
+uint64_t TileLinkTraffic::address(TileLinkRandom& rng, int size) {
+  uint64_t bytes = 1 << size;
+  uint64_t address;
+
+  switch (config.address_pattern) {
+    case ADDRESS_SEQUENTIAL:
+    case ADDRESS_STRIDED:
+      address = align(next_address % ADDRESS_RANGE, bytes);
+      next_address = address + ((config.address_pattern == ADDRESS_SEQUENTIAL)
+                                ? bytes : config.address_stride);
+      return address;
+
+    case ADDRESS_HOTSPOT:
+      if (random_bool(rng, config.hotspot_rate))
+        address = rng.below(std::max(config.hotspot_size, 1));
+      else
+        address = rng.below(ADDRESS_RANGE);
+      return align(address % ADDRESS_RANGE, bytes);
+
+    default:
+      return align(rng.below(ADDRESS_RANGE), bytes);
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef TL_TRAFFIC_H
+#define TL_TRAFFIC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "tilelink.h"
+#include "tl_config.h"
+#include "tl_random.h"
+
+using std::vector;
+
+// Random decisions shaped by an endpoint's traffic profile. Weight tables are
+// converted to cumulative form when the configuration is loaded, so each
+// decision costs one random number.
+class TileLinkTraffic {
+public:
+  TileLinkTraffic(const tl_traffic_config_t& config, int max_size);
+
+  // Start a new request this cycle?
+  bool inject(TileLinkRandom& rng) const {
+    return random_bool(rng, config.injection_rate);
+  }
+
+  // Hold back a beat or response this cycle?
+  bool stall(TileLinkRandom& rng) const {
+    return random_bool(rng, config.stall_rate);
+  }
+
+  // Refuse to accept a beat next cycle?
+  bool apply_backpressure(TileLinkRandom& rng) const {
+    return random_bool(rng, config.backpressure);
+  }
+
+  // log2(bytes) of a new request.
+  int size(TileLinkRandom& rng) const {
+    return random_weighted(rng, size_cumulative);
+  }
+
+  // Opcode of a new A request, using `protocol`.
+  tl_a_op_e a_opcode(TileLinkRandom& rng, tl_protocol_e protocol) const;
+
+  // Offset of a new request within a device's address range, aligned to
+  // 2^`size` bytes.
+  uint64_t address(TileLinkRandom& rng, int size);
+
+  // Relative frequency of an A opcode/request size in the traffic profile.
+  uint64_t opcode_weight(tl_a_op_e opcode) const;
+  uint64_t size_weight(int size) const;
+
+  // Requests are generated within this many bytes of the start of each
+  // device.
+  static const uint64_t ADDRESS_RANGE = 0x1000;
+
+private:
+  const tl_traffic_config_t config;
+
+  vector<uint64_t> size_cumulative;
+
+  // Indexed by protocol.
+  vector<uint64_t> opcode_cumulative[TL_C + 1];
+
+  // Next address for sequential and strided patterns.
+  uint64_t next_address;
+};
+
+#endif // TL_TRAFFIC_H
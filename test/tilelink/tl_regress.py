@@ -0,0 +1,195 @@
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# Run TileLink simulators with many random seeds in parallel. Each job is a
+# simulator built by the Makefile and the C++ configuration it was built for.
+# Results are printed as each run finishes, and coverage from all runs can be
+# merged into a single file.
+
+from argparse import ArgumentParser
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from dataclasses import dataclass
+import os
+import subprocess
+import sys
+import threading
+import time
+
+
+@dataclass
+class Run:
+    sim: str
+    config: str
+    seed: int
+
+    @property
+    def name(self):
+        # Include the configuration so jobs sharing a simulator don't overwrite
+        # each other's logs and coverage.
+        sim = os.path.splitext(os.path.basename(self.sim))[0]
+        config = os.path.splitext(os.path.basename(self.config))[0]
+        return f"{sim}-{config}-seed{self.seed}"
+
+
+@dataclass
+class Result:
+    run: Run
+    passed: bool
+    seconds: float
+    log: str
+    coverage: str
+
+
+class Runner:
+    def __init__(self, args):
+        self.args = args
+        self.stopping = False
+        self.running = set()
+        self.lock = threading.Lock()
+
+    def command(self, run, coverage):
+        command = [os.path.abspath(run.sim),
+                   "--random-seed", str(run.seed),
+                   "--run", str(self.args.cycles),
+                   "--config", run.config]
+        if coverage:
+            command += ["--coverage", coverage]
+        return command + self.args.sim_args
+
+    def execute(self, run):
+        log = os.path.join(self.args.output_dir, run.name + ".log")
+        coverage = None
+        if self.args.coverage:
+            coverage = os.path.join(self.args.output_dir, run.name + ".cov")
+
+        start = time.monotonic()
+        with open(log, "w") as f:
+            process = subprocess.Popen(self.command(run, coverage),
+                                       stdout=f, stderr=subprocess.STDOUT)
+            with self.lock:
+                # Don't start anything new after a failure if asked to stop.
+                if self.stopping:
+                    process.kill()
+                self.running.add(process)
+            returncode = process.wait()
+            with self.lock:
+                self.running.discard(process)
+        seconds = time.monotonic() - start
+
+        # Assertions abort the simulator, so a clean exit is only a pass if the
+        # harness also reached the end of its tests.
+        with open(log) as f:
+            passed = returncode == 0 and "No assertions triggered" in f.read()
+
+        return Result(run, passed, seconds, log, coverage)
+
+    def stop(self):
+        with self.lock:
+            self.stopping = True
+            for process in self.running:
+                process.kill()
+
+    def report(self, result):
+        status = "PASS" if result.passed else "FAIL"
+        rate = self.args.cycles / result.seconds / 1000 if result.seconds else 0
+        print(f"{status} {result.run.name:40} {result.seconds:8.1f}s "
+              f"{rate:10.1f} kcycles/s", flush=True)
+        if not result.passed:
+            print(f"  log: {result.log}")
+            print(f"  rerun: {' '.join(self.command(result.run, None))}",
+                  flush=True)
+
+    def run_all(self, runs):
+        results = []
+        with ThreadPoolExecutor(max_workers=self.args.jobs) as pool:
+            futures = [pool.submit(self.execute, run) for run in runs]
+
+            for future in as_completed(futures):
+                # Results of runs killed or cancelled after a failure aren't
+                # meaningful.
+                if future.cancelled() or self.stopping:
+                    continue
+                result = future.result()
+
+                results.append(result)
+                self.report(result)
+
+                if not result.passed and self.args.stop_on_failure:
+                    self.stop()
+                    for pending in futures:
+                        pending.cancel()
+
+        return results
+
+
+def merge_coverage(results, output):
+    files = [r.coverage for r in results if r.coverage and os.path.exists(r.coverage)]
+    if not files:
+        print("No coverage data to merge")
+        return
+
+    subprocess.run(["verilator_coverage", "-write", output] + files, check=True)
+    print(f"Merged coverage from {len(files)} runs into {output}")
+
+
+def parse_job(job):
+    """Split a SIM:CONFIG argument."""
+    sim, separator, config = job.partition(":")
+    if not separator:
+        print(f"Error: expected SIMULATOR:CONFIG, got {job}")
+        exit(1)
+    return sim, config
+
+
+def main():
+    parser = ArgumentParser(description="Run TileLink simulators with many random seeds in parallel")
+    parser.add_argument("jobs_list", nargs="+", metavar="SIMULATOR:CONFIG",
+                        help="Simulator and the C++ configuration it was built with")
+    parser.add_argument("--seeds", type=int, default=10,
+                        help="Number of random seeds to run for each simulator")
+    parser.add_argument("--first-seed", type=int, default=0,
+                        help="First random seed to use")
+    parser.add_argument("--cycles", type=int, default=1000000,
+                        help="Cycles of random traffic in each run")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(),
+                        help="Number of simulations to run at once (default: all cores)")
+    parser.add_argument("--stop-on-failure", action="store_true",
+                        help="Stop all runs as soon as one fails")
+    parser.add_argument("--coverage", type=str,
+                        help="Collect coverage from every run and merge it into this file")
+    parser.add_argument("--output-dir", type=str, default="regress",
+                        help="Directory for logs and per-run coverage")
+    parser.add_argument("--sim-args", type=str, default="",
+                        help="Extra arguments passed to every simulator")
+
+    args = parser.parse_args()
+    args.sim_args = args.sim_args.split()
+    os.makedirs(args.output_dir, exist_ok=True)
+
+    # Interleave simulators so early results cover every configuration.
+    jobs = [parse_job(job) for job in args.jobs_list]
+    runs = [Run(sim, config, seed)
+            for seed in range(args.first_seed, args.first_seed + args.seeds)
+            for sim, config in jobs]
+
+    print(f"Running {len(runs)} simulations, {args.jobs} at a time")
+    start = time.monotonic()
+    results = Runner(args).run_all(runs)
+    seconds = time.monotonic() - start
+
+    failed = [r for r in results if not r.passed]
+    skipped = len(runs) - len(results)
+    cycles = args.cycles * len(results)
+    print(f"\n{len(results) - len(failed)} passed, {len(failed)} failed, "
+          f"{skipped} not run, in {seconds:.1f}s "
+          f"({cycles / seconds / 1000 if seconds else 0:.1f} kcycles/s overall)")
+
+    if args.coverage:
+        merge_coverage(results, args.coverage)
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()